@@ -0,0 +1,88 @@
+// Append throughput of concurrent_vector across thread counts: 4M ints
+// pushed by 1, 2, 4, ... threads (each pushes an equal share), against a
+// vector guarded by a mutex. grow_by appends in batches of 64.
+//
+//   g++ -std=c++20 -O2 -pthread -Iinclude benchmarks/concurrent_vector_bench.cpp -o concurrent_vector_bench
+//   ./concurrent_vector_bench [max_threads]
+//
+// max_threads defaults to 2 * hardware_concurrency. Counts past the number
+// of cores only show that oversubscription does not stall; scaling needs
+// the cores.
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "concurrent_vector/concurrent_vector.h"
+#include "vector/vector.h"
+
+static constexpr size_t total = size_t(1) << 22;
+static constexpr size_t batch = 64;
+static constexpr int runs = 5;
+
+// Best of runs, in milliseconds, of spreading total appends over threads.
+template <typename Setup, typename Work>
+static double best_ms(size_t threads, Setup setup, Work work) {
+    double best = 1e300;
+    for (int r = 0; r < runs; ++r) {
+        auto state = setup();
+        size_t share = total / threads;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> pool;
+        for (size_t t = 0; t < threads; ++t)
+            pool.emplace_back([&, t] { work(*state, t * share, share); });
+        for (std::thread& th : pool)
+            th.join();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+        if (elapsed.count() < best) best = elapsed.count();
+    }
+    return best;
+}
+
+struct locked_vector {
+    std::mutex mutex;
+    vector<int> values;
+};
+
+int main(int argc, char** argv) {
+    size_t max_threads = argc > 1 ? std::strtoul(argv[1], nullptr, 10)
+                                  : 2 * std::max(1u, std::thread::hardware_concurrency());
+
+    std::printf("%zu hardware threads, %zu appends per run\n", size_t(std::thread::hardware_concurrency()), total);
+    std::printf("threads  push_back  grow_by  mutex+vector   (ms, best of %d)\n", runs);
+
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        double push = best_ms(
+            threads, [] { return std::make_unique<concurrent_vector<int>>(); },
+            [](concurrent_vector<int>& v, size_t first, size_t n) {
+                for (size_t i = 0; i < n; ++i)
+                    v.push_back(int(first + i));
+            });
+
+        double grow = best_ms(
+            threads, [] { return std::make_unique<concurrent_vector<int>>(); },
+            [](concurrent_vector<int>& v, size_t first, size_t n) {
+                for (size_t i = 0; i < n; i += batch)
+                    v.grow_by(std::min(batch, n - i), int(first + i));
+            });
+
+        double locked = best_ms(
+            threads, [] { return std::make_unique<locked_vector>(); },
+            [](locked_vector& v, size_t first, size_t n) {
+                for (size_t i = 0; i < n; ++i) {
+                    std::lock_guard<std::mutex> lock(v.mutex);
+                    v.values.push_back(int(first + i));
+                }
+            });
+
+        std::printf("%7zu  %9.1f  %7.1f  %12.1f\n", threads, push, grow, locked);
+    }
+    return 0;
+}
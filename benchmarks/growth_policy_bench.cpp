@@ -0,0 +1,73 @@
+// Reallocation count, capacity slack and peak resident memory of vector's
+// growth policies on one workload: 20000 vectors of 1..3000 ints filled by
+// push_back, every 1000th of them with 1M ints instead.
+//
+//   g++ -std=c++20 -O2 -Iinclude benchmarks/growth_policy_bench.cpp -o growth_policy_bench
+//   ./growth_policy_bench 2x; ./growth_policy_bench 1.5x; ./growth_policy_bench size-class
+//
+// Run each policy in its own process so maxrss is not shared between them.
+
+#include <cstdio>
+#include <cstring>
+#include <sys/resource.h>
+
+#include "vector/vector.h"
+
+static size_t allocations = 0;
+
+// malloc_allocator that counts allocations; every growth is one.
+template <typename T>
+struct counting_allocator : malloc_allocator<T> {
+    using value_type = T;
+
+    counting_allocator() = default;
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        ++allocations;
+        return malloc_allocator<T>::allocate(n);
+    }
+
+    allocation<T*> allocate_at_least(size_t n) {
+        ++allocations;
+        return malloc_allocator<T>::allocate_at_least(n);
+    }
+};
+
+template <typename Growth>
+void run(const char* name) {
+    static vector<int, counting_allocator<int>, Growth> vectors[20000];
+
+    size_t elements = 0;
+    for (int i = 0; i < 20000; ++i) {
+        int len = i % 1000 == 0 ? 1 << 20 : (i * 7919) % 3000 + 1;
+        for (int j = 0; j < len; ++j)
+            vectors[i].push_back(j);
+        elements += len;
+    }
+
+    size_t capacity = 0;
+    for (const auto& v : vectors)
+        capacity += v.capacity();
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    std::printf("%-10s reallocs=%zu elements=%zu capacity=%zu slack=%.1f%% maxrss=%ldMB\n", name, allocations,
+                elements, capacity, 100.0 * (capacity - elements) / capacity, usage.ru_maxrss / 1024);
+}
+
+int main(int argc, char** argv) {
+    const char* mode = argc > 1 ? argv[1] : "2x";
+
+    if (!std::strcmp(mode, "2x"))
+        run<growth_double>("2x");
+    else if (!std::strcmp(mode, "1.5x"))
+        run<growth_golden>("1.5x");
+    else if (!std::strcmp(mode, "size-class"))
+        run<growth_size_class>("size-class");
+    else {
+        std::fprintf(stderr, "usage: %s 2x|1.5x|size-class\n", argv[0]);
+        return 1;
+    }
+}
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../vector/vector.h"
+
+// Data-parallel for_each, transform, reduce and sort over contiguous storage,
+// run on a shared work-stealing thread pool. A range is cut into chunks of
+// about grain elements whose inner boundaries sit on 64-byte lines, so two
+// threads never write the same cache line. Each participant starts with a
+// contiguous run of chunks and, when it runs out, steals the upper half of
+// another participant's remaining run.
+//
+// The calling thread takes part in the work, a call made from inside a
+// parallel algorithm runs serially, and the first exception thrown by a
+// user function is rethrown to the caller after the remaining chunks are
+// abandoned. parallel_set_threads sets how many threads, the caller
+// included, the shared pool uses; with one thread every call runs serially.
+// reduce combines per-chunk results in chunk order, so for a given grain
+// the result does not depend on the number of threads.
+
+inline constexpr size_t parallel_default_grain = size_t(1) << 14;
+
+class thread_pool
+{
+    static constexpr size_t cache_line = 64;
+
+    // Remaining chunks [begin, end) of one participant, packed as
+    // begin << 32 | end so that pops and steals are a single CAS.
+    struct alignas(cache_line) slot {
+        std::atomic<uint64_t> range{0};
+    };
+
+    struct job {
+        void (*run)(void*, size_t);
+        void* context;
+        std::unique_ptr<slot[]> slots;
+        size_t participants;
+        size_t pending;  // workers yet to leave the job, guarded by mutex_
+        std::atomic<bool> failed{false};
+        std::mutex error_mutex;
+        std::exception_ptr error;
+    };
+
+    std::vector<std::thread> workers_;
+    std::mutex submit_mutex_;
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    job* job_ = nullptr;
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+
+public:
+    // threads counts the calling thread, so thread_pool(1) starts no workers.
+    explicit thread_pool(size_t threads = std::thread::hardware_concurrency()) {
+        start(threads);
+    }
+
+    ~thread_pool() { stop(); }
+
+    thread_pool(const thread_pool&) = delete;
+    thread_pool& operator=(const thread_pool&) = delete;
+
+    // Waits for a running job to finish before restarting the workers.
+    void resize(size_t threads) {
+        std::lock_guard submit(submit_mutex_);
+        stop();
+        start(threads);
+    }
+
+    size_t size() const noexcept { return workers_.size() + 1; }
+
+    // Calls f(chunk) for every chunk in [0, chunks) and returns when all
+    // of them have run.
+    template <typename F>
+    void run(size_t chunks, F&& f) {
+        if (chunks > UINT32_MAX) throw std::length_error("thread_pool: too many chunks");
+        if (chunks <= 1 || workers_.empty() || inside()) {
+            for (size_t c = 0; c < chunks; ++c)
+                f(c);
+            return;
+        }
+
+        std::lock_guard submit(submit_mutex_);
+        using Fn = std::remove_reference_t<F>;
+
+        job j;
+        j.run = [](void* context, size_t chunk) { (*static_cast<Fn*>(context))(chunk); };
+        j.context = const_cast<void*>(static_cast<const void*>(std::addressof(f)));
+        j.participants = std::min(size(), chunks);
+        j.slots.reset(new slot[j.participants]);
+        for (size_t i = 0; i < j.participants; ++i)
+            j.slots[i].range.store(pack(chunks * i / j.participants, chunks * (i + 1) / j.participants),
+                                   std::memory_order_relaxed);
+
+        {
+            std::lock_guard lock(mutex_);
+            j.pending = workers_.size();
+            job_ = &j;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        inside() = true;
+        participate(j, 0);
+        inside() = false;
+
+        {
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [&j] { return j.pending == 0; });
+            job_ = nullptr;
+        }
+
+        if (j.error) std::rethrow_exception(j.error);
+    }
+
+private:
+    static bool& inside() noexcept {
+        static thread_local bool flag = false;
+        return flag;
+    }
+
+    static uint64_t pack(uint64_t begin, uint64_t end) noexcept { return begin << 32 | end; }
+
+    // Takes the first chunk of a run.
+    static bool pop(std::atomic<uint64_t>& range, size_t& chunk) noexcept {
+        uint64_t v = range.load(std::memory_order_acquire);
+        for (;;) {
+            uint64_t begin = v >> 32, end = v & UINT32_MAX;
+            if (begin >= end) return false;
+            if (range.compare_exchange_weak(v, pack(begin + 1, end), std::memory_order_acq_rel)) {
+                chunk = begin;
+                return true;
+            }
+        }
+    }
+
+    // Takes the upper half of a run, or its last chunk.
+    static bool steal(std::atomic<uint64_t>& range, uint64_t& stolen) noexcept {
+        uint64_t v = range.load(std::memory_order_acquire);
+        for (;;) {
+            uint64_t begin = v >> 32, end = v & UINT32_MAX;
+            if (begin >= end) return false;
+            uint64_t mid = begin + (end - begin) / 2;
+            if (range.compare_exchange_weak(v, pack(begin, mid), std::memory_order_acq_rel)) {
+                stolen = pack(mid, end);
+                return true;
+            }
+        }
+    }
+
+    static bool take(job& j, size_t self, size_t& chunk) noexcept {
+        if (pop(j.slots[self].range, chunk)) return true;
+
+        for (size_t k = 1; k < j.participants; ++k) {
+            uint64_t stolen;
+            if (steal(j.slots[(self + k) % j.participants].range, stolen)) {
+                chunk = stolen >> 32;
+                j.slots[self].range.store(pack(chunk + 1, stolen & UINT32_MAX), std::memory_order_release);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    static void participate(job& j, size_t self) {
+        size_t chunk;
+        while (!j.failed.load(std::memory_order_relaxed) && take(j, self, chunk)) {
+            try {
+                j.run(j.context, chunk);
+            } catch (...) {
+                std::lock_guard lock(j.error_mutex);
+                if (!j.error) j.error = std::current_exception();
+                j.failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // seen is the generation when the worker was started, so a job posted
+    // before the thread first takes the lock is not missed.
+    void worker(size_t index, uint64_t seen) {
+        inside() = true;
+        std::unique_lock lock(mutex_);
+        for (;;) {
+            wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+
+            seen = generation_;
+            job* j = job_;
+            lock.unlock();
+            if (index < j->participants) participate(*j, index);
+            lock.lock();
+            if (--j->pending == 0) done_.notify_one();
+        }
+    }
+
+    void start(size_t threads) {
+        stop_ = false;
+        try {
+            for (size_t i = 1; i < threads; ++i)
+                workers_.emplace_back([this, i, seen = generation_] { worker(i, seen); });
+        } catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    void stop() noexcept {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& worker : workers_)
+            worker.join();
+        workers_.clear();
+    }
+};
+
+inline thread_pool& parallel_pool() {
+    static thread_pool pool(std::max(1u, std::thread::hardware_concurrency()));
+    return pool;
+}
+
+// Must not be called while a parallel algorithm is running on another thread.
+inline void parallel_set_threads(size_t threads) {
+    parallel_pool().resize(std::max<size_t>(1, threads));
+}
+
+// Containers whose elements are one array, as for simd_contiguous; the
+// segmented containers (stable_vector, concurrent_vector) do not qualify.
+template <typename Container>
+concept parallel_contiguous = std::ranges::contiguous_range<Container> && std::ranges::sized_range<Container>;
+
+struct parallel_detail {
+    static constexpr size_t cache_line = 64;
+
+    // Chunk 0 is [0, head + step) and chunk c is [head + c * step,
+    // head + (c + 1) * step), clipped to n. head is the distance from the
+    // start of the range to the first cache-line boundary, and step is a
+    // whole number of lines.
+    struct chunking {
+        size_t n, head, step, count;
+
+        size_t begin(size_t c) const noexcept { return c == 0 ? 0 : std::min(n, head + c * step); }
+        size_t end(size_t c) const noexcept { return std::min(n, head + (c + 1) * step); }
+    };
+
+    template <typename T>
+    static chunking chunk(const T* base, size_t n, size_t grain) noexcept {
+        constexpr size_t per_line = sizeof(T) < cache_line && cache_line % sizeof(T) == 0 ? cache_line / sizeof(T) : 1;
+
+        size_t step = std::max<size_t>({grain, 1, (n + UINT32_MAX - 1) / UINT32_MAX});
+        step = (step + per_line - 1) / per_line * per_line;
+
+        size_t head = 0;
+        uintptr_t address = reinterpret_cast<uintptr_t>(base);
+        if (per_line > 1 && address % sizeof(T) == 0)
+            head = std::min(n, (cache_line - address % cache_line) % cache_line / sizeof(T));
+
+        size_t count = n <= head + step ? (n != 0) : (n - head + step - 1) / step;
+        return {n, head, step, count};
+    }
+};
+
+// Calls f(x) for every element, in no particular order.
+template <typename T, typename F>
+void parallel_for_each(T* first, size_t n, F f, size_t grain = parallel_default_grain) {
+    auto chunks = parallel_detail::chunk(first, n, grain);
+    parallel_pool().run(chunks.count, [&](size_t c) {
+        for (size_t i = chunks.begin(c), end = chunks.end(c); i < end; ++i)
+            f(first[i]);
+    });
+}
+
+// out[i] = f(in[i]). Chunks follow the output's cache lines.
+template <typename T, typename U, typename F>
+void parallel_transform(const T* in, size_t n, U* out, F f, size_t grain = parallel_default_grain) {
+    auto chunks = parallel_detail::chunk(out, n, grain);
+    parallel_pool().run(chunks.count, [&](size_t c) {
+        for (size_t i = chunks.begin(c), end = chunks.end(c); i < end; ++i)
+            out[i] = f(in[i]);
+    });
+}
+
+// Folds the range with op, which must be associative: each chunk is folded
+// on its own and the chunk results are folded into init in order.
+template <typename T, typename R, typename Op = std::plus<>>
+R parallel_reduce(const T* first, size_t n, R init, Op op = Op(), size_t grain = parallel_default_grain) {
+    auto chunks = parallel_detail::chunk(first, n, grain);
+    vector<std::optional<R>> partial(chunks.count, std::nullopt);
+    parallel_pool().run(chunks.count, [&](size_t c) {
+        size_t i = chunks.begin(c), end = chunks.end(c);
+        R acc = first[i];
+        for (++i; i < end; ++i)
+            acc = op(std::move(acc), first[i]);
+        partial[c].emplace(std::move(acc));
+    });
+
+    for (size_t c = 0; c < chunks.count; ++c)
+        init = op(std::move(init), std::move(*partial[c]));
+    return init;
+}
+
+// Sorts the chunks in parallel, then merges neighbouring runs in rounds,
+// each round's merges in parallel. The last round is one merge over the
+// whole range. Not stable.
+template <typename T, typename Compare = std::less<>>
+void parallel_sort(T* first, size_t n, Compare comp = Compare(), size_t grain = parallel_default_grain) {
+    thread_pool& pool = parallel_pool();
+    auto chunks = parallel_detail::chunk(first, n, std::max(grain, n / (4 * pool.size())));
+
+    pool.run(chunks.count, [&](size_t c) {
+        std::sort(first + chunks.begin(c), first + chunks.end(c), comp);
+    });
+
+    for (size_t width = 1; width < chunks.count; width *= 2) {
+        pool.run((chunks.count + 2 * width - 1) / (2 * width), [&](size_t m) {
+            size_t lo = 2 * m * width;
+            if (lo + width >= chunks.count) return;
+            size_t hi = std::min(chunks.count, lo + 2 * width);
+            std::inplace_merge(first + chunks.begin(lo), first + chunks.begin(lo + width),
+                               first + chunks.end(hi - 1), comp);
+        });
+    }
+}
+
+template <parallel_contiguous Container, typename F>
+void parallel_for_each(Container& c, F f, size_t grain = parallel_default_grain) {
+    if (!std::ranges::empty(c)) parallel_for_each(std::ranges::data(c), std::ranges::size(c), std::move(f), grain);
+}
+
+template <parallel_contiguous In, parallel_contiguous Out, typename F>
+void parallel_transform(const In& in, Out& out, F f, size_t grain = parallel_default_grain) {
+    if (std::ranges::size(out) < std::ranges::size(in))
+        throw std::invalid_argument("parallel_transform: output is smaller than input");
+    if (!std::ranges::empty(in))
+        parallel_transform(std::ranges::data(in), std::ranges::size(in), std::ranges::data(out), std::move(f), grain);
+}
+
+template <parallel_contiguous Container, typename R, typename Op = std::plus<>>
+R parallel_reduce(const Container& c, R init, Op op = Op(), size_t grain = parallel_default_grain) {
+    if (std::ranges::empty(c)) return init;
+    return parallel_reduce(std::ranges::data(c), std::ranges::size(c), std::move(init), std::move(op), grain);
+}
+
+template <parallel_contiguous Container, typename Compare = std::less<>>
+void parallel_sort(Container& c, Compare comp = Compare(), size_t grain = parallel_default_grain) {
+    if (!std::ranges::empty(c)) parallel_sort(std::ranges::data(c), std::ranges::size(c), std::move(comp), grain);
+}
@@ -0,0 +1,302 @@
+#pragma once
+
+#include <algorithm>
+#include <barrier>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <latch>
+#include <new>
+#include <optional>
+#include <ranges>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "../vector/vector.h"
+
+// Stable LSD radix sort over contiguous storage, for integer and floating
+// point keys or for trivially copyable records sorted by a key extractor.
+// One pass over the input counts every 11-bit digit at once; each remaining
+// pass scatters by one digit into a scratch buffer of n elements, and passes
+// whose digit is the same for every key are skipped. Floats are mapped to
+// unsigned integers that order the same way, with -0.0 before +0.0 and NaNs
+// at either end according to their sign bit.
+//
+// parallel_radix_sort splits the input into one chunk per thread. Threads
+// count their own chunk, derive their write offsets from everyone's counts
+// and scatter independently, so the result is identical to radix_sort. The
+// key extractor must not throw in the parallel variant.
+
+template <typename K>
+concept radix_key = (std::integral<K> && !std::same_as<K, bool>) ||
+                    (std::floating_point<K> && (sizeof(K) == 4 || sizeof(K) == 8));
+
+// Containers whose elements are one array, as for simd_contiguous; the
+// segmented containers (stable_vector, concurrent_vector) do not qualify.
+template <typename Container>
+concept radix_contiguous = std::ranges::contiguous_range<Container> && std::ranges::sized_range<Container>;
+
+struct radix_detail {
+    static constexpr unsigned digit_bits = 11;
+    static constexpr size_t radix = size_t(1) << digit_bits;
+    static constexpr size_t small_size = 64;
+    static constexpr size_t min_chunk = size_t(1) << 16;
+
+    template <typename K>
+    using bits_t = std::make_unsigned_t<std::conditional_t<std::floating_point<K>,
+        std::conditional_t<sizeof(K) == 4, int32_t, int64_t>, K>>;
+
+    // Maps a key to an unsigned integer with the same ordering.
+    template <radix_key K>
+    static bits_t<K> to_bits(K key) noexcept {
+        using U = bits_t<K>;
+        constexpr U sign = U(1) << (sizeof(U) * 8 - 1);
+        if constexpr (std::floating_point<K>) {
+            U b = std::bit_cast<U>(key);
+            return b ^ ((U(0) - (b >> (sizeof(U) * 8 - 1))) | sign);
+        } else if constexpr (std::is_signed_v<K>) {
+            return static_cast<U>(key) ^ sign;
+        } else {
+            return key;
+        }
+    }
+
+    template <typename T, typename KeyFn>
+    static auto bits(const T& value, KeyFn& key) noexcept {
+        return to_bits(std::invoke(key, value));
+    }
+
+    template <typename U>
+    static constexpr size_t passes = (sizeof(U) * 8 + digit_bits - 1) / digit_bits;
+
+    template <typename U>
+    static size_t digit(U b, size_t pass) noexcept {
+        return (b >> (pass * digit_bits)) & (radix - 1);
+    }
+
+    struct identity {
+        template <typename T>
+        const T& operator()(const T& value) const noexcept { return value; }
+    };
+
+    template <typename T>
+    class buffer {
+        T* data_;
+
+    public:
+        explicit buffer(size_t n)
+            : data_(static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))))) {}
+        ~buffer() { ::operator delete(data_, std::align_val_t(alignof(T))); }
+
+        buffer(const buffer&) = delete;
+        buffer& operator=(const buffer&) = delete;
+
+        T* get() const noexcept { return data_; }
+    };
+
+    template <typename T, typename KeyFn>
+    static void insertion_sort(T* data, size_t n, KeyFn& key) {
+        for (size_t i = 1; i < n; ++i) {
+            T value = data[i];
+            auto b = bits(value, key);
+            size_t j = i;
+            for (; j > 0 && b < bits(data[j - 1], key); --j)
+                data[j] = data[j - 1];
+            data[j] = value;
+        }
+    }
+
+    // A pass can be skipped when one digit value accounts for every key.
+    static bool trivial_pass(const size_t* counts, size_t n) noexcept {
+        for (size_t d = 0; d < radix; ++d)
+            if (counts[d] != 0) return counts[d] == n;
+        return true;
+    }
+
+    template <typename T, typename KeyFn>
+    static void sort(T* data, size_t n, KeyFn key) {
+        if (n <= small_size) {
+            insertion_sort(data, n, key);
+            return;
+        }
+
+        using U = decltype(bits(*data, key));
+        constexpr size_t passes = radix_detail::passes<U>;
+
+        vector<size_t> counts(passes * radix, 0);  // [pass][digit]
+        for (size_t i = 0; i < n; ++i) {
+            U b = bits(data[i], key);
+            for (size_t p = 0; p < passes; ++p)
+                ++counts[p * radix + digit(b, p)];
+        }
+
+        buffer<T> scratch(n);
+        T* src = data;
+        T* dst = scratch.get();
+        for (size_t p = 0; p < passes; ++p) {
+            if (trivial_pass(counts.data() + p * radix, n)) continue;
+
+            size_t offsets[radix];
+            size_t sum = 0;
+            for (size_t d = 0; d < radix; ++d) {
+                offsets[d] = sum;
+                sum += counts[p * radix + d];
+            }
+            for (size_t i = 0; i < n; ++i)
+                dst[offsets[digit(bits(src[i], key), p)]++] = src[i];
+            std::swap(src, dst);
+        }
+
+        if (src != data) std::memcpy(static_cast<void*>(data), src, n * sizeof(T));
+    }
+
+    template <typename T, typename KeyFn>
+    static void parallel_sort(T* data, size_t n, KeyFn key, size_t threads) {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        threads = std::min(threads, std::max<size_t>(1, n / min_chunk));
+        if (threads == 1) {
+            sort(data, n, key);
+            return;
+        }
+
+        using U = decltype(bits(*data, key));
+        constexpr size_t passes = radix_detail::passes<U>;
+
+        buffer<T> scratch(n);
+        vector<size_t> initial(threads * passes * radix, 0);  // [thread][pass][digit]
+        vector<size_t> counts(threads * radix, 0);            // [thread][digit]
+
+        std::latch go(1);
+        std::optional<std::barrier<>> sync;
+        size_t active = 1;
+
+        auto run = [&](size_t t) noexcept {
+            T* src = data;
+            T* dst = scratch.get();
+            size_t begin = n * t / active;
+            size_t end = n * (t + 1) / active;
+
+            size_t* mine = initial.data() + t * passes * radix;
+            for (size_t i = begin; i < end; ++i) {
+                U b = bits(src[i], key);
+                for (size_t p = 0; p < passes; ++p)
+                    ++mine[p * radix + digit(b, p)];
+            }
+            sync->arrive_and_wait();
+
+            bool first = true;
+            for (size_t p = 0; p < passes; ++p) {
+                size_t total[radix] = {};
+                for (size_t u = 0; u < active; ++u)
+                    for (size_t d = 0; d < radix; ++d)
+                        total[d] += initial[(u * passes + p) * radix + d];
+                if (trivial_pass(total, n)) continue;
+
+                // Before the first scatter every chunk still holds its
+                // original keys, so the initial counts can be reused.
+                size_t* count = counts.data() + t * radix;
+                if (first) {
+                    std::memcpy(count, mine + p * radix, radix * sizeof(size_t));
+                    first = false;
+                } else {
+                    std::memset(count, 0, radix * sizeof(size_t));
+                    for (size_t i = begin; i < end; ++i)
+                        ++count[digit(bits(src[i], key), p)];
+                }
+                sync->arrive_and_wait();
+
+                // Digit d of thread t goes after all smaller digits and after
+                // digit d of the threads before it, which keeps the sort stable.
+                size_t offsets[radix];
+                size_t sum = 0;
+                for (size_t d = 0; d < radix; ++d) {
+                    size_t at = sum;
+                    for (size_t u = 0; u < t; ++u)
+                        at += counts[u * radix + d];
+                    offsets[d] = at;
+                    sum += total[d];
+                }
+                for (size_t i = begin; i < end; ++i)
+                    dst[offsets[digit(bits(src[i], key), p)]++] = src[i];
+                sync->arrive_and_wait();
+
+                std::swap(src, dst);
+            }
+
+            if (src != data && begin != end)
+                std::memcpy(static_cast<void*>(data + begin), src + begin, (end - begin) * sizeof(T));
+        };
+
+        // Threads that fail to start are left out and the rest share the work.
+        std::vector<std::thread> pool;
+        pool.reserve(threads - 1);
+        try {
+            for (size_t t = 1; t < threads; ++t) {
+                pool.emplace_back([&, t] { go.wait(); run(t); });
+                ++active;
+            }
+        } catch (const std::system_error&) {
+        }
+
+        sync.emplace(static_cast<std::ptrdiff_t>(active));
+        go.count_down();
+        run(0);
+        for (std::thread& thread : pool)
+            thread.join();
+    }
+};
+
+template <radix_key T>
+void radix_sort(T* data, size_t n) {
+    radix_detail::sort(data, n, radix_detail::identity{});
+}
+
+// Sorts records by key(record), which must return an integer or floating
+// point value. Records with equal keys keep their relative order.
+template <typename T, typename KeyFn>
+    requires std::invocable<KeyFn&, const T&> && radix_key<std::remove_cvref_t<std::invoke_result_t<KeyFn&, const T&>>>
+void radix_sort(T* data, size_t n, KeyFn key) {
+    static_assert(std::is_trivially_copyable_v<T>, "radix_sort moves records with memcpy");
+    radix_detail::sort(data, n, key);
+}
+
+// threads == 0 uses one thread per hardware thread. Inputs too small to
+// give every thread a useful chunk use fewer threads.
+template <radix_key T>
+void parallel_radix_sort(T* data, size_t n, size_t threads = 0) {
+    radix_detail::parallel_sort(data, n, radix_detail::identity{}, threads);
+}
+
+template <typename T, typename KeyFn>
+    requires std::invocable<KeyFn&, const T&> && radix_key<std::remove_cvref_t<std::invoke_result_t<KeyFn&, const T&>>>
+void parallel_radix_sort(T* data, size_t n, KeyFn key, size_t threads = 0) {
+    static_assert(std::is_trivially_copyable_v<T>, "parallel_radix_sort moves records with memcpy");
+    radix_detail::parallel_sort(data, n, key, threads);
+}
+
+template <radix_contiguous Container>
+void radix_sort(Container& c) {
+    if (!std::ranges::empty(c)) radix_sort(std::ranges::data(c), std::ranges::size(c));
+}
+
+template <radix_contiguous Container, typename KeyFn>
+void radix_sort(Container& c, KeyFn key) {
+    if (!std::ranges::empty(c)) radix_sort(std::ranges::data(c), std::ranges::size(c), key);
+}
+
+template <radix_contiguous Container>
+void parallel_radix_sort(Container& c, size_t threads = 0) {
+    if (!std::ranges::empty(c)) parallel_radix_sort(std::ranges::data(c), std::ranges::size(c), threads);
+}
+
+template <radix_contiguous Container, typename KeyFn>
+    requires (!std::integral<KeyFn>)
+void parallel_radix_sort(Container& c, KeyFn key, size_t threads = 0) {
+    if (!std::ranges::empty(c)) parallel_radix_sort(std::ranges::data(c), std::ranges::size(c), key, threads);
+}
@@ -0,0 +1,628 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ranges>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#include <immintrin.h>
+#define SIMD_X86 1
+#define SIMD_TARGET_SSE42 __attribute__((target("sse4.2")))
+#define SIMD_TARGET_AVX2 __attribute__((target("avx2")))
+#define SIMD_TARGET_AVX512 __attribute__((target("avx512f")))
+#endif
+
+// Search and compare kernels over contiguous storage: find, count, contains,
+// min_max, equal and fill. int32_t, uint32_t and float ranges are dispatched
+// at runtime to SSE4.2, AVX2 or AVX-512 code, everything else runs the scalar
+// loop. Every entry point takes either a pointer and a length or a contiguous
+// container such as vector or stack. simd_popcount counts set bits in an
+// array of 64-bit words, for bitmaps.
+//
+// simd_set_level caps the level used by the dispatcher (never above what the
+// CPU supports), so each implementation can be exercised on one machine.
+// min_max leaves the result unspecified when a float range contains NaN.
+
+enum class simd_level { scalar, sse42, avx2, avx512 };
+
+inline simd_level simd_detected_level() noexcept {
+#if defined(SIMD_X86)
+    static const simd_level level = [] {
+        __builtin_cpu_init();
+        if (__builtin_cpu_supports("avx512f")) return simd_level::avx512;
+        if (__builtin_cpu_supports("avx2")) return simd_level::avx2;
+        if (__builtin_cpu_supports("sse4.2")) return simd_level::sse42;
+        return simd_level::scalar;
+    }();
+    return level;
+#else
+    return simd_level::scalar;
+#endif
+}
+
+struct simd_dispatch {
+    static std::atomic<simd_level>& level() noexcept {
+        static std::atomic<simd_level> active{simd_detected_level()};
+        return active;
+    }
+
+    template <typename T>
+    static constexpr bool vectorized =
+        std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> || std::is_same_v<T, float>;
+};
+
+inline simd_level simd_active_level() noexcept {
+    return simd_dispatch::level().load(std::memory_order_relaxed);
+}
+
+inline void simd_set_level(simd_level level) noexcept {
+    simd_level cap = simd_detected_level();
+    simd_dispatch::level().store(level < cap ? level : cap, std::memory_order_relaxed);
+}
+
+struct simd_scalar {
+    template <typename T>
+    static size_t find(const T* p, size_t n, T value) {
+        for (size_t i = 0; i < n; ++i)
+            if (p[i] == value) return i;
+        return n;
+    }
+
+    template <typename T>
+    static size_t count(const T* p, size_t n, T value) {
+        size_t c = 0;
+        for (size_t i = 0; i < n; ++i)
+            c += p[i] == value;
+        return c;
+    }
+
+    template <typename T>
+    static std::pair<T, T> min_max(const T* p, size_t n) {
+        T lo = p[0], hi = p[0];
+        for (size_t i = 1; i < n; ++i) {
+            if (p[i] < lo) lo = p[i];
+            if (hi < p[i]) hi = p[i];
+        }
+        return {lo, hi};
+    }
+
+    template <typename T>
+    static bool equal(const T* a, const T* b, size_t n) {
+        for (size_t i = 0; i < n; ++i)
+            if (!(a[i] == b[i])) return false;
+        return true;
+    }
+
+    template <typename T>
+    static void fill(T* p, size_t n, T value) {
+        for (size_t i = 0; i < n; ++i)
+            p[i] = value;
+    }
+
+    static size_t popcount(const uint64_t* p, size_t n) {
+        size_t c = 0;
+        for (size_t i = 0; i < n; ++i)
+            c += std::popcount(p[i]);
+        return c;
+    }
+};
+
+#if defined(SIMD_X86)
+
+struct simd_sse42 {
+    static constexpr size_t width = 4;
+
+    template <typename T>
+    SIMD_TARGET_SSE42 static __m128i load(const T* p) {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    }
+
+    template <typename T>
+    SIMD_TARGET_SSE42 static __m128i splat(T v) {
+        int32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return _mm_set1_epi32(bits);
+    }
+
+    template <typename T>
+    SIMD_TARGET_SSE42 static unsigned eq_mask(__m128i a, __m128i b) {
+        if constexpr (std::is_same_v<T, float>)
+            return _mm_movemask_ps(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+        else
+            return _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(a, b)));
+    }
+
+    template <typename T>
+    SIMD_TARGET_SSE42 static __m128i vmin(__m128i a, __m128i b) {
+        if constexpr (std::is_same_v<T, float>)
+            return _mm_castps_si128(_mm_min_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+        else if constexpr (std::is_same_v<T, uint32_t>)
+            return _mm_min_epu32(a, b);
+        else
+            return _mm_min_epi32(a, b);
+    }
+
+    template <typename T>
+    SIMD_TARGET_SSE42 static __m128i vmax(__m128i a, __m128i b) {
+        if constexpr (std::is_same_v<T, float>)
+            return _mm_castps_si128(_mm_max_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+        else if constexpr (std::is_same_v<T, uint32_t>)
+            return _mm_max_epu32(a, b);
+        else
+            return _mm_max_epi32(a, b);
+    }
+
+    template <typename T>
+    SIMD_TARGET_SSE42 static size_t find(const T* p, size_t n, T value) {
+        __m128i needle = splat(value);
+        size_t i = 0;
+        for (; i + width <= n; i += width) {
+            unsigned m = eq_mask<T>(load(p + i), needle);
+            if (m) return i + std::countr_zero(m);
+        }
+        for (; i < n; ++i)
+            if (p[i] == value) return i;
+        return n;
+    }
+
+    template <typename T>
+    SIMD_TARGET_SSE42 static size_t count(const T* p, size_t n, T value) {
+        __m128i needle = splat(value);
+        size_t c = 0, i = 0;
+        for (; i + width <= n; i += width)
+            c += std::popcount(eq_mask<T>(load(p + i), needle));
+        for (; i < n; ++i)
+            c += p[i] == value;
+        return c;
+    }
+
+    template <typename T>
+    SIMD_TARGET_SSE42 static std::pair<T, T> min_max(const T* p, size_t n) {
+        if (n < width) return simd_scalar::min_max(p, n);
+
+        __m128i lo = load(p), hi = lo;
+        size_t i = width;
+        for (; i + width <= n; i += width) {
+            __m128i v = load(p + i);
+            lo = vmin<T>(lo, v);
+            hi = vmax<T>(hi, v);
+        }
+
+        T los[width], his[width];
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(los), lo);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(his), hi);
+        std::pair<T, T> r{simd_scalar::min_max(los, width).first, simd_scalar::min_max(his, width).second};
+        for (; i < n; ++i) {
+            if (p[i] < r.first) r.first = p[i];
+            if (r.second < p[i]) r.second = p[i];
+        }
+        return r;
+    }
+
+    template <typename T>
+    SIMD_TARGET_SSE42 static bool equal(const T* a, const T* b, size_t n) {
+        size_t i = 0;
+        for (; i + width <= n; i += width)
+            if (eq_mask<T>(load(a + i), load(b + i)) != 0xF) return false;
+        return simd_scalar::equal(a + i, b + i, n - i);
+    }
+
+    template <typename T>
+    SIMD_TARGET_SSE42 static void fill(T* p, size_t n, T value) {
+        __m128i v = splat(value);
+        size_t i = 0;
+        for (; i + width <= n; i += width)
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(p + i), v);
+        for (; i < n; ++i)
+            p[i] = value;
+    }
+
+    // sse4.2 implies the popcnt instruction; four accumulators hide its latency.
+    SIMD_TARGET_SSE42 static size_t popcount(const uint64_t* p, size_t n) {
+        size_t c0 = 0, c1 = 0, c2 = 0, c3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            c0 += std::popcount(p[i]);
+            c1 += std::popcount(p[i + 1]);
+            c2 += std::popcount(p[i + 2]);
+            c3 += std::popcount(p[i + 3]);
+        }
+        for (; i < n; ++i)
+            c0 += std::popcount(p[i]);
+        return c0 + c1 + c2 + c3;
+    }
+};
+
+struct simd_avx2 {
+    static constexpr size_t width = 8;
+
+    template <typename T>
+    SIMD_TARGET_AVX2 static __m256i load(const T* p) {
+        return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX2 static __m256i splat(T v) {
+        int32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return _mm256_set1_epi32(bits);
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX2 static unsigned eq_mask(__m256i a, __m256i b) {
+        if constexpr (std::is_same_v<T, float>)
+            return _mm256_movemask_ps(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+        else
+            return _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(a, b)));
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX2 static __m256i vmin(__m256i a, __m256i b) {
+        if constexpr (std::is_same_v<T, float>)
+            return _mm256_castps_si256(_mm256_min_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+        else if constexpr (std::is_same_v<T, uint32_t>)
+            return _mm256_min_epu32(a, b);
+        else
+            return _mm256_min_epi32(a, b);
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX2 static __m256i vmax(__m256i a, __m256i b) {
+        if constexpr (std::is_same_v<T, float>)
+            return _mm256_castps_si256(_mm256_max_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b)));
+        else if constexpr (std::is_same_v<T, uint32_t>)
+            return _mm256_max_epu32(a, b);
+        else
+            return _mm256_max_epi32(a, b);
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX2 static size_t find(const T* p, size_t n, T value) {
+        __m256i needle = splat(value);
+        size_t i = 0;
+        for (; i + width <= n; i += width) {
+            unsigned m = eq_mask<T>(load(p + i), needle);
+            if (m) return i + std::countr_zero(m);
+        }
+        for (; i < n; ++i)
+            if (p[i] == value) return i;
+        return n;
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX2 static size_t count(const T* p, size_t n, T value) {
+        __m256i needle = splat(value);
+        size_t c = 0, i = 0;
+        for (; i + width <= n; i += width)
+            c += std::popcount(eq_mask<T>(load(p + i), needle));
+        for (; i < n; ++i)
+            c += p[i] == value;
+        return c;
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX2 static std::pair<T, T> min_max(const T* p, size_t n) {
+        if (n < width) return simd_scalar::min_max(p, n);
+
+        __m256i lo = load(p), hi = lo;
+        size_t i = width;
+        for (; i + width <= n; i += width) {
+            __m256i v = load(p + i);
+            lo = vmin<T>(lo, v);
+            hi = vmax<T>(hi, v);
+        }
+
+        T los[width], his[width];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(los), lo);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(his), hi);
+        std::pair<T, T> r{simd_scalar::min_max(los, width).first, simd_scalar::min_max(his, width).second};
+        for (; i < n; ++i) {
+            if (p[i] < r.first) r.first = p[i];
+            if (r.second < p[i]) r.second = p[i];
+        }
+        return r;
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX2 static bool equal(const T* a, const T* b, size_t n) {
+        size_t i = 0;
+        for (; i + width <= n; i += width)
+            if (eq_mask<T>(load(a + i), load(b + i)) != 0xFF) return false;
+        return simd_scalar::equal(a + i, b + i, n - i);
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX2 static void fill(T* p, size_t n, T value) {
+        __m256i v = splat(value);
+        size_t i = 0;
+        for (; i + width <= n; i += width)
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + i), v);
+        for (; i < n; ++i)
+            p[i] = value;
+    }
+
+    // Nibble lookup through vpshufb, summed per 64-bit lane with vpsadbw.
+    SIMD_TARGET_AVX2 static size_t popcount(const uint64_t* p, size_t n) {
+        const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                               0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        __m256i total = _mm256_setzero_si256();
+
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4) {
+            __m256i v = load(p + i);
+            __m256i lo = _mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble));
+            __m256i hi = _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble));
+            total = _mm256_add_epi64(total, _mm256_sad_epu8(_mm256_add_epi8(lo, hi), _mm256_setzero_si256()));
+        }
+
+        uint64_t lanes[4];
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes), total);
+        size_t c = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+        for (; i < n; ++i)
+            c += std::popcount(p[i]);
+        return c;
+    }
+};
+
+// GCC 12 reports the self-initialized placeholder inside AVX-512 intrinsics
+// as possibly uninitialized.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#endif
+
+struct simd_avx512 {
+    static constexpr size_t width = 16;
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static __m512i load(const T* p) {
+        return _mm512_loadu_si512(p);
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static __m512i load_partial(const T* p, __mmask16 k) {
+        return _mm512_maskz_loadu_epi32(k, p);
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static __m512i splat(T v) {
+        int32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        return _mm512_set1_epi32(bits);
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static __mmask16 eq_mask(__m512i a, __m512i b) {
+        if constexpr (std::is_same_v<T, float>)
+            return _mm512_cmp_ps_mask(_mm512_castsi512_ps(a), _mm512_castsi512_ps(b), _CMP_EQ_OQ);
+        else
+            return _mm512_cmpeq_epi32_mask(a, b);
+    }
+
+    static __mmask16 tail_mask(size_t left) {
+        return static_cast<__mmask16>((1u << left) - 1);
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static size_t find(const T* p, size_t n, T value) {
+        __m512i needle = splat(value);
+        size_t i = 0;
+        for (; i + width <= n; i += width) {
+            unsigned m = eq_mask<T>(load(p + i), needle);
+            if (m) return i + std::countr_zero(m);
+        }
+        if (i < n) {
+            __mmask16 k = tail_mask(n - i);
+            unsigned m = eq_mask<T>(load_partial(p + i, k), needle) & k;
+            if (m) return i + std::countr_zero(m);
+        }
+        return n;
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static size_t count(const T* p, size_t n, T value) {
+        __m512i needle = splat(value);
+        size_t c = 0, i = 0;
+        for (; i + width <= n; i += width)
+            c += std::popcount(static_cast<unsigned>(eq_mask<T>(load(p + i), needle)));
+        if (i < n) {
+            __mmask16 k = tail_mask(n - i);
+            c += std::popcount(static_cast<unsigned>(eq_mask<T>(load_partial(p + i, k), needle) & k));
+        }
+        return c;
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static std::pair<T, T> min_max(const T* p, size_t n) {
+        if (n < width) return simd_scalar::min_max(p, n);
+
+        if constexpr (std::is_same_v<T, float>) {
+            __m512 lo = _mm512_loadu_ps(p), hi = lo;
+            size_t i = width;
+            for (; i + width <= n; i += width) {
+                __m512 v = _mm512_loadu_ps(p + i);
+                lo = _mm512_min_ps(lo, v);
+                hi = _mm512_max_ps(hi, v);
+            }
+            if (i < n) {
+                __m512 v = _mm512_loadu_ps(p + n - width);
+                lo = _mm512_min_ps(lo, v);
+                hi = _mm512_max_ps(hi, v);
+            }
+            return {_mm512_reduce_min_ps(lo), _mm512_reduce_max_ps(hi)};
+        } else {
+            __m512i lo = load(p), hi = lo;
+            size_t i = width;
+            for (; i + width <= n; i += width) {
+                __m512i v = load(p + i);
+                lo = vmin<T>(lo, v);
+                hi = vmax<T>(hi, v);
+            }
+            if (i < n) {
+                __m512i v = load(p + n - width);
+                lo = vmin<T>(lo, v);
+                hi = vmax<T>(hi, v);
+            }
+            if constexpr (std::is_same_v<T, uint32_t>)
+                return {_mm512_reduce_min_epu32(lo), _mm512_reduce_max_epu32(hi)};
+            else
+                return {_mm512_reduce_min_epi32(lo), _mm512_reduce_max_epi32(hi)};
+        }
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static __m512i vmin(__m512i a, __m512i b) {
+        if constexpr (std::is_same_v<T, uint32_t>)
+            return _mm512_min_epu32(a, b);
+        else
+            return _mm512_min_epi32(a, b);
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static __m512i vmax(__m512i a, __m512i b) {
+        if constexpr (std::is_same_v<T, uint32_t>)
+            return _mm512_max_epu32(a, b);
+        else
+            return _mm512_max_epi32(a, b);
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static bool equal(const T* a, const T* b, size_t n) {
+        size_t i = 0;
+        for (; i + width <= n; i += width)
+            if (eq_mask<T>(load(a + i), load(b + i)) != 0xFFFF) return false;
+        if (i < n) {
+            __mmask16 k = tail_mask(n - i);
+            if ((eq_mask<T>(load_partial(a + i, k), load_partial(b + i, k)) & k) != k) return false;
+        }
+        return true;
+    }
+
+    template <typename T>
+    SIMD_TARGET_AVX512 static void fill(T* p, size_t n, T value) {
+        __m512i v = splat(value);
+        size_t i = 0;
+        for (; i + width <= n; i += width)
+            _mm512_storeu_si512(p + i, v);
+        if (i < n)
+            _mm512_mask_storeu_epi32(p + i, tail_mask(n - i), v);
+    }
+};
+
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+#define SIMD_DISPATCH(kernel, T, ...)                                         \
+    if constexpr (simd_dispatch::vectorized<T>) {                              \
+        switch (simd_active_level()) {                                         \
+        case simd_level::avx512: return simd_avx512::kernel<T>(__VA_ARGS__);   \
+        case simd_level::avx2: return simd_avx2::kernel<T>(__VA_ARGS__);       \
+        case simd_level::sse42: return simd_sse42::kernel<T>(__VA_ARGS__);     \
+        case simd_level::scalar: break;                                        \
+        }                                                                      \
+    }                                                                          \
+    return simd_scalar::kernel<T>(__VA_ARGS__)
+
+#else
+
+#define SIMD_DISPATCH(kernel, T, ...) return simd_scalar::kernel<T>(__VA_ARGS__)
+
+#endif
+
+template <typename T>
+size_t simd_find(const T* data, size_t n, T value) {
+    SIMD_DISPATCH(find, T, data, n, value);
+}
+
+template <typename T>
+size_t simd_count(const T* data, size_t n, T value) {
+    SIMD_DISPATCH(count, T, data, n, value);
+}
+
+template <typename T>
+bool simd_contains(const T* data, size_t n, T value) {
+    return simd_find(data, n, value) != n;
+}
+
+template <typename T>
+std::pair<T, T> simd_min_max(const T* data, size_t n) {
+    if (n == 0) throw std::invalid_argument("simd_min_max: empty range");
+    SIMD_DISPATCH(min_max, T, data, n);
+}
+
+template <typename T>
+bool simd_equal(const T* a, const T* b, size_t n) {
+    SIMD_DISPATCH(equal, T, a, b, n);
+}
+
+template <typename T>
+void simd_fill(T* data, size_t n, T value) {
+    SIMD_DISPATCH(fill, T, data, n, value);
+}
+
+#undef SIMD_DISPATCH
+
+// Number of set bits in n 64-bit words. AVX-512F alone has no byte shuffle
+// or vector popcount, so that level uses the AVX2 kernel.
+inline size_t simd_popcount(const uint64_t* words, size_t n) noexcept {
+#if defined(SIMD_X86)
+    switch (simd_active_level()) {
+    case simd_level::avx512:
+    case simd_level::avx2: return simd_avx2::popcount(words, n);
+    case simd_level::sse42: return simd_sse42::popcount(words, n);
+    case simd_level::scalar: break;
+    }
+#endif
+    return simd_scalar::popcount(words, n);
+}
+
+// Containers whose elements really are one array: std::ranges::data gives
+// their first element and the rest follow it. Segmented containers with an
+// operator[] (stable_vector, concurrent_vector, persistent_vector) do not
+// qualify.
+template <typename Container>
+concept simd_contiguous = std::ranges::contiguous_range<Container> && std::ranges::sized_range<Container>;
+
+template <typename Container>
+using simd_element_t = std::ranges::range_value_t<Container>;
+
+template <simd_contiguous Container>
+size_t simd_find(const Container& c, const simd_element_t<Container>& value) {
+    return std::ranges::empty(c) ? 0 : simd_find(std::ranges::data(c), std::ranges::size(c), value);
+}
+
+template <simd_contiguous Container>
+size_t simd_count(const Container& c, const simd_element_t<Container>& value) {
+    return std::ranges::empty(c) ? 0 : simd_count(std::ranges::data(c), std::ranges::size(c), value);
+}
+
+template <simd_contiguous Container>
+bool simd_contains(const Container& c, const simd_element_t<Container>& value) {
+    return !std::ranges::empty(c) && simd_contains(std::ranges::data(c), std::ranges::size(c), value);
+}
+
+template <simd_contiguous Container>
+std::pair<simd_element_t<Container>, simd_element_t<Container>> simd_min_max(const Container& c) {
+    if (std::ranges::empty(c)) throw std::invalid_argument("simd_min_max: empty range");
+    return simd_min_max(std::ranges::data(c), std::ranges::size(c));
+}
+
+template <simd_contiguous Container>
+bool simd_equal(const Container& a, const Container& b) {
+    if (std::ranges::size(a) != std::ranges::size(b)) return false;
+    return std::ranges::empty(a) || simd_equal(std::ranges::data(a), std::ranges::data(b), std::ranges::size(a));
+}
+
+template <simd_contiguous Container>
+void simd_fill(Container& c, const simd_element_t<Container>& value) {
+    if (!std::ranges::empty(c)) simd_fill(std::ranges::data(c), std::ranges::size(c), value);
+}
@@ -0,0 +1,246 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+
+// Monotonic (bump) arena for request-scoped containers. Allocation moves a
+// pointer through the current chunk; deallocation does nothing, except that
+// freeing the most recent allocation gives its bytes back. Memory returns
+// all at once: release() hands every chunk back to the upstream, and an
+// arena_scope rewinds the arena to where it stood when the scope opened in
+// O(1), keeping the chunks for the next request. Scopes nest.
+//
+// Chunks come from an arena_upstream: the heap by default, null_upstream()
+// to fail with bad_alloc once a caller-supplied buffer is full, or another
+// monotonic_arena, so a child arena draws from its parent and everything
+// goes back when the parent is released.
+//
+// arena_allocator<T> adapts an arena to the Allocator parameter of vector,
+// stack, list, deque and unordered_set. Containers must be destroyed before
+// the arena is released or their scope closes. Not thread-safe; use one
+// arena per thread.
+
+class arena_upstream
+{
+public:
+    virtual void* allocate(size_t bytes, size_t alignment) = 0;
+    virtual void deallocate(void* p, size_t bytes, size_t alignment) noexcept = 0;
+
+protected:
+    ~arena_upstream() = default;
+};
+
+struct arena_detail {
+    struct heap final : arena_upstream {
+        void* allocate(size_t bytes, size_t alignment) override {
+            return ::operator new(bytes, std::align_val_t(alignment));
+        }
+        void deallocate(void* p, size_t bytes, size_t alignment) noexcept override {
+            ::operator delete(p, bytes, std::align_val_t(alignment));
+        }
+    };
+
+    struct null final : arena_upstream {
+        void* allocate(size_t, size_t) override { throw std::bad_alloc(); }
+        void deallocate(void*, size_t, size_t) noexcept override {}
+    };
+
+    static std::byte* align_up(std::byte* p, size_t alignment) noexcept {
+        uintptr_t v = reinterpret_cast<uintptr_t>(p);
+        return p + ((alignment - v % alignment) % alignment);
+    }
+};
+
+inline arena_upstream& heap_upstream() noexcept {
+    static arena_detail::heap upstream;
+    return upstream;
+}
+
+inline arena_upstream& null_upstream() noexcept {
+    static arena_detail::null upstream;
+    return upstream;
+}
+
+class monotonic_arena final : public arena_upstream
+{
+    // Header at the start of each chunk taken from the upstream. Chunks
+    // form a list in the order they are used; after a rewind the ones past
+    // current_ are reused before asking the upstream again.
+    struct chunk {
+        chunk* next;
+        size_t bytes;
+
+        std::byte* begin() noexcept { return reinterpret_cast<std::byte*>(this) + sizeof(chunk); }
+        std::byte* end() noexcept { return reinterpret_cast<std::byte*>(this) + bytes; }
+    };
+
+    static constexpr size_t chunk_alignment = alignof(std::max_align_t);
+
+    std::byte* buffer_ = nullptr;  // caller-supplied initial buffer
+    size_t buffer_size_ = 0;
+    chunk* head_ = nullptr;
+    chunk* current_ = nullptr;  // null while in the initial buffer
+    std::byte* cur_ = nullptr;
+    std::byte* end_ = nullptr;
+    size_t next_chunk_ = 0;
+    arena_upstream* upstream_;
+
+public:
+    static constexpr size_t default_chunk_size = 64 * 1024;
+
+    // Position of an arena, for rewinding to it.
+    struct mark {
+        chunk* current;
+        std::byte* cur;
+    };
+
+    explicit monotonic_arena(size_t chunk_size = default_chunk_size, arena_upstream& upstream = heap_upstream())
+        : next_chunk_(chunk_size < 2 * sizeof(chunk) ? 2 * sizeof(chunk) : chunk_size), upstream_(&upstream) {}
+
+    // Serves allocations from buffer first, then from chunks of the
+    // upstream; with null_upstream() the buffer is all there is.
+    monotonic_arena(void* buffer, size_t size, arena_upstream& upstream = heap_upstream(),
+                    size_t chunk_size = default_chunk_size)
+        : buffer_(static_cast<std::byte*>(buffer)), buffer_size_(size), cur_(buffer_), end_(buffer_ + size),
+          next_chunk_(chunk_size < 2 * sizeof(chunk) ? 2 * sizeof(chunk) : chunk_size), upstream_(&upstream) {}
+
+    monotonic_arena(const monotonic_arena&) = delete;
+    monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+    ~monotonic_arena() { release(); }
+
+    void* allocate(size_t bytes, size_t alignment) override {
+        std::byte* p = arena_detail::align_up(cur_, alignment);
+        if (!cur_ || size_t(end_ - cur_) < bytes + size_t(p - cur_)) p = next_chunk(bytes, alignment);
+        cur_ = p + bytes;
+        return p;
+    }
+
+    void deallocate(void* p, size_t bytes, size_t) noexcept override {
+        if (static_cast<std::byte*>(p) + bytes == cur_) cur_ = static_cast<std::byte*>(p);
+    }
+
+    mark position() const noexcept { return {current_, cur_}; }
+
+    // Frees everything allocated since m was taken, keeping the chunks.
+    void rewind(mark m) noexcept {
+        current_ = m.current;
+        cur_ = m.cur;
+        end_ = current_ ? current_->end() : buffer_ + buffer_size_;
+    }
+
+    // Returns every chunk to the upstream and starts over at the initial
+    // buffer.
+    void release() noexcept {
+        while (head_) {
+            chunk* next = head_->next;
+            upstream_->deallocate(head_, head_->bytes, chunk_alignment);
+            head_ = next;
+        }
+        current_ = nullptr;
+        cur_ = buffer_;
+        end_ = buffer_ + buffer_size_;
+    }
+
+    arena_upstream& upstream() const noexcept { return *upstream_; }
+
+    // Bytes obtained from the upstream, chunk headers included.
+    size_t reserved() const noexcept {
+        size_t total = 0;
+        for (chunk* c = head_; c; c = c->next)
+            total += c->bytes;
+        return total;
+    }
+
+private:
+    // Moves to the next chunk with room for bytes at alignment, reusing a
+    // kept chunk when it fits and otherwise inserting a new one after the
+    // current chunk.
+    std::byte* next_chunk(size_t bytes, size_t alignment) {
+        chunk* next = current_ ? current_->next : head_;
+        if (next) {
+            std::byte* p = arena_detail::align_up(next->begin(), alignment);
+            if (p <= next->end() && size_t(next->end() - p) >= bytes) {
+                enter(next);
+                return p;
+            }
+        }
+
+        size_t need = sizeof(chunk) + bytes + (alignment > chunk_alignment ? alignment : 0);
+        if (need < bytes) throw std::bad_alloc();
+        size_t size = next_chunk_ > need ? next_chunk_ : need;
+
+        chunk* c = static_cast<chunk*>(upstream_->allocate(size, chunk_alignment));
+        c->bytes = size;
+        c->next = next;
+        if (current_)
+            current_->next = c;
+        else
+            head_ = c;
+        if (next_chunk_ <= SIZE_MAX / 2) next_chunk_ *= 2;
+
+        enter(c);
+        return arena_detail::align_up(c->begin(), alignment);
+    }
+
+    void enter(chunk* c) noexcept {
+        current_ = c;
+        cur_ = c->begin();
+        end_ = c->end();
+    }
+};
+
+// Rewinds arena to where it stood at construction when the scope ends.
+class arena_scope
+{
+    monotonic_arena& arena_;
+    monotonic_arena::mark mark_;
+
+public:
+    explicit arena_scope(monotonic_arena& arena) noexcept : arena_(arena), mark_(arena.position()) {}
+
+    arena_scope(const arena_scope&) = delete;
+    arena_scope& operator=(const arena_scope&) = delete;
+
+    ~arena_scope() { arena_.rewind(mark_); }
+};
+
+// Allocator drawing from a monotonic_arena. Allocators compare equal when
+// they share an arena. Move assignment and swap carry the arena along with
+// the elements, matching how the containers hand their storage over.
+template <typename T>
+class arena_allocator
+{
+    monotonic_arena* arena_;
+
+    template <typename U>
+    friend class arena_allocator;
+
+public:
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::false_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+    using is_always_equal = std::false_type;
+
+    arena_allocator(monotonic_arena& arena) noexcept : arena_(&arena) {}
+
+    template <typename U>
+    arena_allocator(const arena_allocator<U>& other) noexcept : arena_(other.arena_) {}
+
+    T* allocate(size_t n) {
+        if (n > SIZE_MAX / sizeof(T)) throw std::bad_array_new_length();
+        return static_cast<T*>(arena_->allocate(n * sizeof(T), alignof(T)));
+    }
+
+    void deallocate(T* p, size_t n) noexcept { arena_->deallocate(p, n * sizeof(T), alignof(T)); }
+
+    monotonic_arena& arena() const noexcept { return *arena_; }
+
+    template <typename U>
+    bool operator==(const arena_allocator<U>& other) const noexcept {
+        return arena_ == other.arena_;
+    }
+};
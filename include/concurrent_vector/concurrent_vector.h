@@ -0,0 +1,414 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Append-only vector for many producer threads. Storage uses the same
+// geometric blocks as stable_vector, so elements never move and a block is
+// installed with a single compare-exchange. push_back and grow_by claim slots
+// with one fetch_add on reserved_ and construct outside any lock. Each slot
+// has a ready flag; a producer sets its flags and then advances published_
+// over the longest run of ready slots, so size() only covers fully
+// constructed elements and nobody waits on a slower producer: whoever
+// finishes the lowest pending slot carries the prefix forward.
+//
+// Once a slot is claimed it has to be published, so an element constructor
+// or block allocation that throws during an append terminates the program.
+// clear, copy, move and destruction are not thread-safe.
+template <typename T, typename Alloc = std::allocator<T>>
+class concurrent_vector
+{
+    using traits = std::allocator_traits<Alloc>;
+    using flag = std::atomic<unsigned char>;
+    using flag_alloc = typename traits::template rebind_alloc<flag>;
+    using flag_traits = std::allocator_traits<flag_alloc>;
+    using pointer = T*;
+    using reference = T&;
+    using constReference = const T&;
+
+    static constexpr size_t first_block_shift = 4;
+    static constexpr size_t first_block = size_t(1) << first_block_shift;
+    static constexpr size_t max_blocks = sizeof(size_t) * 8 - first_block_shift;
+
+    template <bool Const>
+    class basic_iterator {
+        using owner = std::conditional_t<Const, const concurrent_vector, concurrent_vector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+    private:
+        owner* vec_;
+        size_t index_;
+
+        friend class concurrent_vector;
+        friend class basic_iterator<!Const>;
+
+    public:
+        basic_iterator() : vec_(nullptr), index_(0) {}
+        basic_iterator(owner* vec, size_t index) : vec_(vec), index_(index) {}
+
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& it) : vec_(it.vec_), index_(it.index_) {}
+
+        reference operator*() const { return (*vec_)[index_]; }
+        pointer operator->() const { return &(*vec_)[index_]; }
+        reference operator[](difference_type n) const { return (*vec_)[index_ + n]; }
+
+        basic_iterator& operator++() { ++index_; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp = *this; ++index_; return temp; }
+        basic_iterator& operator--() { --index_; return *this; }
+        basic_iterator operator--(int) { basic_iterator temp = *this; --index_; return temp; }
+
+        basic_iterator& operator+=(difference_type n) { index_ += n; return *this; }
+        basic_iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+
+        basic_iterator operator+(difference_type n) const { return basic_iterator(vec_, index_ + n); }
+        basic_iterator operator-(difference_type n) const { return basic_iterator(vec_, index_ - n); }
+        difference_type operator-(const basic_iterator& other) const {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        friend basic_iterator operator+(difference_type n, const basic_iterator& it) { return it + n; }
+
+        bool operator==(const basic_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const basic_iterator& other) const { return index_ != other.index_; }
+        bool operator<(const basic_iterator& other) const { return index_ < other.index_; }
+        bool operator>(const basic_iterator& other) const { return index_ > other.index_; }
+        bool operator<=(const basic_iterator& other) const { return index_ <= other.index_; }
+        bool operator>=(const basic_iterator& other) const { return index_ >= other.index_; }
+    };
+
+public:
+    using Iterator = basic_iterator<false>;
+    using ConstIterator = basic_iterator<true>;
+
+private:
+    std::atomic<pointer> blocks_[max_blocks] = {};
+    std::atomic<flag*> ready_[max_blocks] = {};
+    std::atomic<size_t> reserved_{0};
+    std::atomic<size_t> published_{0};
+    Alloc alloc_;
+
+public:
+    concurrent_vector() = default;
+
+    explicit concurrent_vector(const Alloc& alloc) : alloc_(alloc) {}
+
+    concurrent_vector(const concurrent_vector& other)
+        : alloc_(traits::select_on_container_copy_construction(other.alloc_)) {
+        build(other.size(), [&other](pointer p, size_t i) { std::construct_at(p, other[i]); });
+    }
+
+    concurrent_vector(concurrent_vector&& other) noexcept : alloc_(std::move(other.alloc_)) {
+        steal(other);
+    }
+
+    // The allocator follows propagate_on_container_copy_assignment. When it
+    // does not propagate, the elements are copied into blocks from this
+    // vector's own allocator.
+    concurrent_vector& operator=(const concurrent_vector& other) {
+        if (this == &other) return *this;
+
+        auto copy = [&other](pointer p, size_t i) { std::construct_at(p, other[i]); };
+
+        if constexpr (traits::propagate_on_container_copy_assignment::value) {
+            if (!same_allocator(other)) {
+                concurrent_vector tmp(other.alloc_);
+                tmp.build(other.size(), copy);
+                clear();
+                deallocate_blocks();
+                alloc_ = other.alloc_;
+                steal(tmp);
+                return *this;
+            }
+            alloc_ = other.alloc_;
+        }
+
+        concurrent_vector tmp(alloc_);
+        tmp.build(other.size(), copy);
+        clear();
+        deallocate_blocks();
+        steal(tmp);
+        return *this;
+    }
+
+    // Blocks from an allocator that neither propagates on move nor compares
+    // equal cannot be freed by ours, so the elements are moved one by one.
+    concurrent_vector& operator=(concurrent_vector&& other) noexcept(
+        traits::propagate_on_container_move_assignment::value || traits::is_always_equal::value) {
+        if (this == &other) return *this;
+
+        if constexpr (!traits::propagate_on_container_move_assignment::value) {
+            if (!same_allocator(other)) {
+                concurrent_vector tmp(alloc_);
+                tmp.build(other.size(), [&other](pointer p, size_t i) { std::construct_at(p, std::move(other[i])); });
+                clear();
+                deallocate_blocks();
+                steal(tmp);
+                return *this;
+            }
+        }
+
+        clear();
+        deallocate_blocks();
+        if constexpr (traits::propagate_on_container_move_assignment::value)
+            alloc_ = std::move(other.alloc_);
+        steal(other);
+        return *this;
+    }
+
+    ~concurrent_vector() {
+        clear();
+        deallocate_blocks();
+    }
+
+    size_t push_back(const T& value) {
+        return emplace_back(value);
+    }
+
+    size_t push_back(T&& value) {
+        return emplace_back(std::move(value));
+    }
+
+    // Returns the index of the new element.
+    template <typename... Args>
+    size_t emplace_back(Args&&... args) {
+        size_t index = reserved_.fetch_add(1, std::memory_order_relaxed);
+        append_at(index, std::forward<Args>(args)...);
+        return index;
+    }
+
+    // Appends n default-constructed elements and returns the index of the first.
+    size_t grow_by(size_t n) {
+        return grow_by_impl(n, [](pointer p) { std::construct_at(p); });
+    }
+
+    size_t grow_by(size_t n, const T& value) {
+        return grow_by_impl(n, [&value](pointer p) { std::construct_at(p, value); });
+    }
+
+    // Preallocates blocks so that appends up to n elements never allocate.
+    // Safe to call concurrently with appends.
+    void reserve(size_t n) {
+        for (size_t k = 0; capacity_of(k) < n; ++k)
+            ensure_block(k);
+    }
+
+    void clear() noexcept {
+        size_t n = reserved_.load(std::memory_order_acquire);
+        for (size_t i = 0; i < n; ++i) {
+            std::destroy_at(locate(i));
+            locate_flag(i)->store(0, std::memory_order_relaxed);
+        }
+        reserved_.store(0, std::memory_order_relaxed);
+        published_.store(0, std::memory_order_release);
+    }
+
+    reference operator[](size_t i) { return *locate(i); }
+    constReference operator[](size_t i) const { return *locate(i); }
+
+    reference at(size_t ind) {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return *locate(ind);
+    }
+
+    constReference at(size_t ind) const {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return *locate(ind);
+    }
+
+    size_t size() const noexcept { return published_.load(std::memory_order_acquire); }
+    bool empty() const noexcept { return size() == 0; }
+
+    size_t capacity() const noexcept {
+        size_t k = 0;
+        while (k < max_blocks && blocks_[k].load(std::memory_order_acquire))
+            ++k;
+        return capacity_of(k);
+    }
+
+    // end() snapshots size(), so iteration covers the elements published by
+    // the time it was called.
+    Iterator begin() noexcept { return Iterator(this, 0); }
+    Iterator end() noexcept { return Iterator(this, size()); }
+
+    ConstIterator begin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator end() const noexcept { return ConstIterator(this, size()); }
+
+    ConstIterator cbegin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator cend() const noexcept { return ConstIterator(this, size()); }
+
+private:
+    static size_t block_size(size_t k) noexcept { return first_block << k; }
+
+    static size_t capacity_of(size_t blocks) noexcept {
+        return (first_block << blocks) - first_block;
+    }
+
+    static size_t block_of(size_t i) noexcept {
+        return std::bit_width(i + first_block) - 1 - first_block_shift;
+    }
+
+    pointer locate(size_t i) const noexcept {
+        size_t j = i + first_block;
+        size_t top = std::bit_width(j) - 1;
+        return blocks_[top - first_block_shift].load(std::memory_order_acquire) + (j - (size_t(1) << top));
+    }
+
+    flag* locate_flag(size_t i) const noexcept {
+        size_t j = i + first_block;
+        size_t top = std::bit_width(j) - 1;
+        flag* flags = ready_[top - first_block_shift].load(std::memory_order_acquire);
+        return flags ? flags + (j - (size_t(1) << top)) : nullptr;
+    }
+
+    bool is_ready(size_t i) const noexcept {
+        if (block_of(i) >= max_blocks) return false;
+        flag* f = locate_flag(i);
+        return f && f->load(std::memory_order_seq_cst);
+    }
+
+    // Flags go in before the element block, so a slot with storage always
+    // has a flag to set.
+    void ensure_flags(size_t k) {
+        if (ready_[k].load(std::memory_order_acquire)) return;
+
+        flag_alloc fa(alloc_);
+        flag* fresh = flag_traits::allocate(fa, block_size(k));
+        std::uninitialized_value_construct_n(fresh, block_size(k));
+
+        flag* expected = nullptr;
+        if (!ready_[k].compare_exchange_strong(expected, fresh, std::memory_order_acq_rel))
+            flag_traits::deallocate(fa, fresh, block_size(k));
+    }
+
+    pointer ensure_block(size_t k) {
+        if (k >= max_blocks) throw std::length_error("concurrent_vector: too many elements");
+
+        ensure_flags(k);
+        pointer block = blocks_[k].load(std::memory_order_acquire);
+        if (block) return block;
+
+        pointer fresh = traits::allocate(alloc_, block_size(k));
+        if (blocks_[k].compare_exchange_strong(block, fresh, std::memory_order_acq_rel))
+            return fresh;
+
+        traits::deallocate(alloc_, fresh, block_size(k));
+        return block;
+    }
+
+    pointer ensure_slot(size_t i) {
+        size_t j = i + first_block;
+        size_t top = std::bit_width(j) - 1;
+        return ensure_block(top - first_block_shift) + (j - (size_t(1) << top));
+    }
+
+    template <typename... Args>
+    void append_at(size_t index, Args&&... args) noexcept {
+        std::construct_at(ensure_slot(index), std::forward<Args>(args)...);
+        publish(index, 1);
+    }
+
+    template <typename Construct>
+    size_t grow_by_impl(size_t n, Construct construct_one) {
+        size_t first = reserved_.fetch_add(n, std::memory_order_relaxed);
+        if (n > 0) append_range(first, n, construct_one);
+        return first;
+    }
+
+    template <typename Construct>
+    void append_range(size_t first, size_t n, Construct& construct_one) noexcept {
+        for (size_t k = block_of(first), last = block_of(first + n - 1); k <= last; ++k)
+            ensure_block(k);
+        for (size_t i = first; i < first + n; ++i)
+            construct_one(locate(i));
+
+        publish(first, n);
+    }
+
+    // Extends published_ over [first, first + count) and every ready slot
+    // past it. If our range is next in line it is published directly;
+    // otherwise its flags are set for whoever moves the prefix up to it. The
+    // flag stores and published_ accesses are seq_cst: of two producers
+    // finishing adjacent slots, at least one sees the other's progress, so no
+    // ready slot is left behind an unmoved prefix.
+    void publish(size_t first, size_t count) noexcept {
+        size_t p = first;
+        if (published_.compare_exchange_strong(p, first + count, std::memory_order_seq_cst)) {
+            p = first + count;
+        } else {
+            for (size_t i = first; i < first + count; ++i)
+                locate_flag(i)->store(1, std::memory_order_seq_cst);
+            p = published_.load(std::memory_order_seq_cst);
+        }
+
+        for (;;) {
+            size_t q = p;
+            while (is_ready(q))
+                ++q;
+            if (q == p) return;
+            if (published_.compare_exchange_weak(p, q, std::memory_order_seq_cst))
+                p = q;
+        }
+    }
+
+    void deallocate_blocks() noexcept {
+        for (size_t k = 0; k < max_blocks; ++k) {
+            pointer block = blocks_[k].exchange(nullptr, std::memory_order_relaxed);
+            if (block) traits::deallocate(alloc_, block, block_size(k));
+
+            flag* flags = ready_[k].exchange(nullptr, std::memory_order_relaxed);
+            if (flags) {
+                flag_alloc fa(alloc_);
+                flag_traits::deallocate(fa, flags, block_size(k));
+            }
+        }
+    }
+
+    // Fills an empty vector with n elements, make(p, i) constructing element
+    // i at p. reserved_ counts the elements built so far, so a throw is
+    // unwound with clear() and the blocks are freed before it leaves.
+    template <typename Make>
+    void build(size_t n, Make make) {
+        try {
+            reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                make(locate(i), i);
+                locate_flag(i)->store(1, std::memory_order_relaxed);
+                reserved_.store(i + 1, std::memory_order_relaxed);
+            }
+        } catch (...) {
+            clear();
+            deallocate_blocks();
+            throw;
+        }
+        published_.store(n, std::memory_order_release);
+    }
+
+    bool same_allocator(const concurrent_vector& other) const noexcept {
+        if constexpr (traits::is_always_equal::value)
+            return true;
+        else
+            return alloc_ == other.alloc_;
+    }
+
+    void steal(concurrent_vector& other) noexcept {
+        for (size_t k = 0; k < max_blocks; ++k) {
+            blocks_[k].store(other.blocks_[k].exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+            ready_[k].store(other.ready_[k].exchange(nullptr, std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        reserved_.store(other.reserved_.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        published_.store(other.published_.exchange(0, std::memory_order_relaxed), std::memory_order_release);
+    }
+};
@@ -0,0 +1,234 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+#include "../vector/vector.h"
+
+// Copy-on-write vector. Copies share one reference-counted block, so taking
+// a snapshot is O(1); the first mutation through a shared copy clones the
+// elements into a block of its own. Reads through a const cow_vector never
+// clone, while the non-const operator[], at, front, back, data, begin and
+// end do, since they hand out mutable access. Read through a const
+// reference (or std::as_const, cbegin) to keep sharing.
+//
+// The count is atomic: copies of one cow_vector can be used, copied and
+// modified on different threads, as with shared_ptr. A single cow_vector is
+// not safe to modify from two threads. References and iterators obtained
+// through non-const access must not be used after the vector is copied,
+// because writes through them would show up in the copy.
+template <typename T, typename Alloc = std::allocator<T>>
+class cow_vector
+{
+    using storage = vector<T, Alloc>;
+    using reference = T&;
+    using constReference = const T&;
+
+    struct block {
+        std::atomic<size_t> refs;
+        storage items;
+
+        template <typename... Args>
+        explicit block(Args&&... args) : refs(1), items(std::forward<Args>(args)...) {}
+    };
+
+    using block_alloc = typename std::allocator_traits<Alloc>::template rebind_alloc<block>;
+    using block_traits = std::allocator_traits<block_alloc>;
+
+public:
+    using Iterator = typename storage::Iterator;
+    using ConstIterator = typename storage::ConstIterator;
+
+private:
+    block* block_ = nullptr;
+    [[no_unique_address]] block_alloc alloc_;
+
+public:
+    cow_vector() = default;
+
+    cow_vector(size_t n, const T& value) : block_(make_block(n, value)) {}
+
+    // Takes the elements of items without copying them.
+    explicit cow_vector(storage items) : block_(make_block(std::move(items))) {}
+
+    cow_vector(std::initializer_list<T> init) {
+        storage items;
+        items.reserve(init.size());
+        for (const T& value : init)
+            items.push_back(value);
+        block_ = make_block(std::move(items));
+    }
+
+    cow_vector(const cow_vector& other) noexcept : block_(other.block_), alloc_(other.alloc_) {
+        if (block_) block_->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    cow_vector(cow_vector&& other) noexcept : block_(other.block_), alloc_(other.alloc_) {
+        other.block_ = nullptr;
+    }
+
+    cow_vector& operator=(const cow_vector& other) noexcept {
+        cow_vector tmp(other);
+        swap(tmp);
+        return *this;
+    }
+
+    cow_vector& operator=(cow_vector&& other) noexcept {
+        cow_vector tmp(std::move(other));
+        swap(tmp);
+        return *this;
+    }
+
+    ~cow_vector() { release(); }
+
+    void swap(cow_vector& other) noexcept {
+        std::swap(block_, other.block_);
+        std::swap(alloc_, other.alloc_);
+    }
+
+    // Number of cow_vectors sharing this one's elements; 0 when empty and
+    // unallocated.
+    size_t use_count() const noexcept { return block_ ? block_->refs.load(std::memory_order_acquire) : 0; }
+    bool shared() const noexcept { return use_count() > 1; }
+
+    // The elements as a read-only vector, without cloning.
+    const storage& items() const noexcept { return block_ ? block_->items : empty_storage(); }
+
+    constReference operator[](size_t i) const { return items()[i]; }
+    constReference at(size_t ind) const { return items().at(ind); }
+    constReference front() const { return items().front(); }
+    constReference back() const { return items().back(); }
+    const T* data() const { return items().data(); }
+
+    reference operator[](size_t i) { return mut()[i]; }
+    reference at(size_t ind) {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return mut()[ind];
+    }
+    reference front() { return mut().front(); }
+    reference back() { return mut().back(); }
+    T* data() { return mut().data(); }
+
+    size_t size() const noexcept { return items().size(); }
+    size_t capacity() const noexcept { return items().capacity(); }
+    bool empty() const noexcept { return items().empty(); }
+
+    void reserve(size_t n) {
+        if (n > capacity()) mut().reserve(n);
+    }
+
+    void shrink_to_fit() {
+        if (size() != capacity()) mut().shrink_to_fit();
+    }
+
+    void resize(size_t n) {
+        if (n != size()) mut().resize(n);
+    }
+
+    void resize(size_t n, const T& value) {
+        if (n != size()) mut().resize(n, value);
+    }
+
+    void push_back(const T& value) { mut().push_back(value); }
+    void push_back(T&& value) { mut().push_back(std::move(value)); }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        mut().emplace_back(std::forward<Args>(args)...);
+    }
+
+    void pop_back() { mut().pop_back(); }
+
+    // A shared vector just lets go of its block instead of cloning it.
+    void clear() noexcept {
+        if (shared()) release();
+        else if (block_) block_->items.clear();
+    }
+
+    Iterator insert(ConstIterator pos, constReference value) {
+        return emplace(pos, value);
+    }
+
+    Iterator insert(ConstIterator pos, T&& value) {
+        return emplace(pos, std::move(value));
+    }
+
+    // pos may come from cbegin() of the shared block; it is turned into an
+    // index before the clone.
+    template <typename... Args>
+    Iterator emplace(ConstIterator pos, Args&&... args) {
+        size_t index = pos - cbegin();
+        storage& items = mut();
+        return items.emplace(items.cbegin() + index, std::forward<Args>(args)...);
+    }
+
+    Iterator erase(ConstIterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+    Iterator erase(ConstIterator first, ConstIterator last) {
+        size_t start = first - cbegin();
+        size_t count = last - first;
+        storage& items = mut();
+        return items.erase(items.cbegin() + start, items.cbegin() + start + count);
+    }
+
+    Iterator begin() { return mut().begin(); }
+    Iterator end() { return mut().end(); }
+
+    ConstIterator begin() const noexcept { return items().begin(); }
+    ConstIterator end() const noexcept { return items().end(); }
+
+    ConstIterator cbegin() const noexcept { return items().cbegin(); }
+    ConstIterator cend() const noexcept { return items().cend(); }
+
+    friend bool operator==(const cow_vector& a, const cow_vector& b) {
+        if (a.block_ == b.block_) return true;
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    static const storage& empty_storage() noexcept {
+        static const storage empty;
+        return empty;
+    }
+
+    template <typename... Args>
+    block* make_block(Args&&... args) {
+        block* p = block_traits::allocate(alloc_, 1);
+        try {
+            block_traits::construct(alloc_, p, std::forward<Args>(args)...);
+        } catch (...) {
+            block_traits::deallocate(alloc_, p, 1);
+            throw;
+        }
+        return p;
+    }
+
+    void release() noexcept {
+        if (block_ && block_->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            block_traits::destroy(alloc_, block_);
+            block_traits::deallocate(alloc_, block_, 1);
+        }
+        block_ = nullptr;
+    }
+
+    // The elements of a block this vector owns alone, cloning a shared one.
+    // A count of 1 cannot rise under us: only copies of this vector could
+    // raise it, and there are none.
+    storage& mut() {
+        if (!block_) {
+            block_ = make_block();
+        } else if (block_->refs.load(std::memory_order_acquire) != 1) {
+            block* copy = make_block(block_->items);
+            release();
+            block_ = copy;
+        }
+        return block_->items;
+    }
+};
@@ -2,6 +2,9 @@
 #include <iostream>
 #include <iterator>
 
+#include "../tracing/growth_trace.h"
+#include "../tracing/memory_usage.h"
+
 template <typename T, typename Alloc = std::allocator<T>>
 class deque {
 public:
@@ -12,6 +15,7 @@ public:
     using traits = std::allocator_traits<Alloc>;
     using segment_alloc = typename traits::template rebind_alloc<T>;
     using map_alloc = typename traits::template rebind_alloc<pointer>;
+    using map_traits = std::allocator_traits<map_alloc>;
 
     static constexpr size_t block_size =
         (sizeof(T) < 256) ? 4096 / sizeof(T) : 16;
@@ -80,10 +84,13 @@ private:
     map_alloc map_alloc_;
 
 public:
-    deque()
-        : map_(nullptr), map_size_(0), num_segments_(0) {
+    deque() : deque(Alloc()) {}
+
+    explicit deque(const Alloc& alloc)
+        : map_(nullptr), map_size_(0), num_segments_(0), seg_alloc_(alloc), map_alloc_(alloc) {
         reserve_map(8); 
         map_[0] = allocate_segment();
+        num_segments_ = 1;
         start_.set_node(map_);
         start_.curr = start_.first;
         finish_ = start_;
@@ -96,14 +103,14 @@ public:
         }
     }
 
+    // finish_ always points into an allocated segment, so the next one is
+    // allocated before the last slot of the current one is filled.
     void push_back(const T& value) {
-        if (finish_.curr == finish_.last) {
+        if (finish_.curr + 1 == finish_.last && finish_.node + 1 == map_ + num_segments_) {
             if (num_segments_ + 1 >= map_size_) {
                 resize_map(map_size_ * 2);
             }
             map_[num_segments_] = allocate_segment();
-            finish_.set_node(map_ + num_segments_);
-            finish_.curr = finish_.first;
             ++num_segments_;
         }
         traits::construct(seg_alloc_, finish_.curr, value);
@@ -120,6 +127,7 @@ public:
             }
             map_[0] = allocate_segment();
             ++num_segments_;
+            ++finish_.node;
             start_.set_node(map_);
             start_.curr = start_.last;
         }
@@ -127,6 +135,20 @@ public:
         traits::construct(seg_alloc_, start_.curr, value);
     }
 
+    size_t size() const noexcept {
+        return (finish_.node - start_.node) * block_size + (finish_.curr - finish_.first) - (start_.curr - start_.first);
+    }
+
+    bool empty() const noexcept { return start_.curr == finish_.curr; }
+
+    // Unused slots of the allocated segments are slack; the map is overhead.
+    memory_usage_breakdown memory_breakdown() const noexcept {
+        size_t payload = size() * sizeof(T);
+        return {payload, map_size_ * sizeof(pointer), num_segments_ * block_size * sizeof(T) - payload};
+    }
+
+    size_t memory_usage() const noexcept { return memory_breakdown().total(); }
+
     void print_debug() {
         auto it = start_;
         while (it != finish_) {
@@ -142,18 +164,22 @@ private:
     }
 
     void reserve_map(size_t n) {
-        map_ = traits::allocate(map_alloc_, n);
+        map_ = map_traits::allocate(map_alloc_, n);
         map_size_ = n;
     }
 
     void resize_map(size_t new_size) {
-        pointer* new_map = traits::allocate(map_alloc_, new_size);
+        growth_trace trace(growth_site::deque, this, map_size_, sizeof(pointer));
+        pointer* new_map = map_traits::allocate(map_alloc_, new_size);
         for (size_t i = 0; i < num_segments_; ++i) {
             new_map[i] = map_[i];
         }
-        map_alloc_.deallocate(map_, map_size_);
+        start_.node = new_map + (start_.node - map_);
+        finish_.node = new_map + (finish_.node - map_);
+        map_traits::deallocate(map_alloc_, map_, map_size_);
         map_ = new_map;
         map_size_ = new_size;
+        trace.finish(new_size);
     }
 
     void clear() {
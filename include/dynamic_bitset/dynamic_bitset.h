@@ -0,0 +1,229 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "../algorithm/simd.h"
+#include "../vector/vector.h"
+
+// Resizable bitset packed 64 bits to a word in a vector<uint64_t>. Bitwise
+// operators work a word at a time, count() goes through simd_popcount, and
+// find_first/find_next skip zero words and use countr_zero within a word.
+// Bits past size() in the last word are always zero, so whole-word
+// operations never need masking on the read side.
+//
+// set, reset, flip, test and operator[] do not check the index; at() does.
+class dynamic_bitset
+{
+public:
+    using word_type = uint64_t;
+
+    static constexpr size_t bits_per_word = 64;
+    static constexpr size_t npos = static_cast<size_t>(-1);
+
+private:
+    vector<word_type> words_;
+    size_t size_ = 0;
+
+public:
+    dynamic_bitset() = default;
+
+    explicit dynamic_bitset(size_t n, bool value = false)
+        : words_(words_for(n), value ? ~word_type(0) : word_type(0)), size_(n) {
+        clear_unused_bits();
+    }
+
+    void reserve(size_t n) {
+        words_.reserve(words_for(n));
+    }
+
+    void resize(size_t n, bool value = false) {
+        if (n > size_ && value && size_ % bits_per_word != 0)
+            words_[size_ / bits_per_word] |= ~word_type(0) << (size_ % bits_per_word);
+
+        words_.resize(words_for(n), value ? ~word_type(0) : word_type(0));
+        size_ = n;
+        clear_unused_bits();
+    }
+
+    void push_back(bool value) {
+        if (size_ % bits_per_word == 0) words_.push_back(0);
+        words_[size_ / bits_per_word] |= word_type(value) << (size_ % bits_per_word);
+        ++size_;
+    }
+
+    void pop_back() noexcept {
+        if (size_ == 0) return;
+
+        --size_;
+        if (size_ % bits_per_word == 0) words_.pop_back();
+        else clear_unused_bits();
+    }
+
+    void clear() noexcept {
+        words_.clear();
+        size_ = 0;
+    }
+
+    dynamic_bitset& set(size_t i) noexcept {
+        words_[i / bits_per_word] |= bit(i);
+        return *this;
+    }
+
+    dynamic_bitset& set(size_t i, bool value) noexcept {
+        return value ? set(i) : reset(i);
+    }
+
+    dynamic_bitset& set() noexcept {
+        for (size_t w = 0; w < words_.size(); ++w)
+            words_[w] = ~word_type(0);
+        clear_unused_bits();
+        return *this;
+    }
+
+    dynamic_bitset& reset(size_t i) noexcept {
+        words_[i / bits_per_word] &= ~bit(i);
+        return *this;
+    }
+
+    dynamic_bitset& reset() noexcept {
+        for (size_t w = 0; w < words_.size(); ++w)
+            words_[w] = 0;
+        return *this;
+    }
+
+    dynamic_bitset& flip(size_t i) noexcept {
+        words_[i / bits_per_word] ^= bit(i);
+        return *this;
+    }
+
+    dynamic_bitset& flip() noexcept {
+        for (size_t w = 0; w < words_.size(); ++w)
+            words_[w] = ~words_[w];
+        clear_unused_bits();
+        return *this;
+    }
+
+    bool test(size_t i) const noexcept {
+        return (words_[i / bits_per_word] & bit(i)) != 0;
+    }
+
+    bool operator[](size_t i) const noexcept { return test(i); }
+
+    bool at(size_t ind) const {
+        if (ind >= size_) throw std::out_of_range("Index is out of range");
+        return test(ind);
+    }
+
+    size_t count() const noexcept {
+        return simd_popcount(words_.data(), words_.size());
+    }
+
+    bool any() const noexcept {
+        for (size_t w = 0; w < words_.size(); ++w)
+            if (words_[w] != 0) return true;
+        return false;
+    }
+
+    bool none() const noexcept { return !any(); }
+    bool all() const noexcept { return count() == size_; }
+
+    // Index of the first set bit, or npos.
+    size_t find_first() const noexcept {
+        return find_from_word(0);
+    }
+
+    // Index of the first set bit after pos, or npos.
+    size_t find_next(size_t pos) const noexcept {
+        if (pos == npos || pos + 1 >= size_) return npos;
+
+        ++pos;
+        size_t w = pos / bits_per_word;
+        word_type rest = words_[w] >> (pos % bits_per_word);
+        if (rest != 0) return pos + std::countr_zero(rest);
+        return find_from_word(w + 1);
+    }
+
+    dynamic_bitset& operator&=(const dynamic_bitset& other) {
+        check_same_size(other);
+        for (size_t w = 0; w < words_.size(); ++w)
+            words_[w] &= other.words_[w];
+        return *this;
+    }
+
+    dynamic_bitset& operator|=(const dynamic_bitset& other) {
+        check_same_size(other);
+        for (size_t w = 0; w < words_.size(); ++w)
+            words_[w] |= other.words_[w];
+        return *this;
+    }
+
+    dynamic_bitset& operator^=(const dynamic_bitset& other) {
+        check_same_size(other);
+        for (size_t w = 0; w < words_.size(); ++w)
+            words_[w] ^= other.words_[w];
+        return *this;
+    }
+
+    // Clears every bit that is set in other.
+    dynamic_bitset& subtract(const dynamic_bitset& other) {
+        check_same_size(other);
+        for (size_t w = 0; w < words_.size(); ++w)
+            words_[w] &= ~other.words_[w];
+        return *this;
+    }
+
+    dynamic_bitset operator~() const {
+        dynamic_bitset result(*this);
+        result.flip();
+        return result;
+    }
+
+    friend dynamic_bitset operator&(dynamic_bitset a, const dynamic_bitset& b) { return a &= b; }
+    friend dynamic_bitset operator|(dynamic_bitset a, const dynamic_bitset& b) { return a |= b; }
+    friend dynamic_bitset operator^(dynamic_bitset a, const dynamic_bitset& b) { return a ^= b; }
+
+    bool operator==(const dynamic_bitset& other) const noexcept {
+        if (size_ != other.size_) return false;
+        for (size_t w = 0; w < words_.size(); ++w)
+            if (words_[w] != other.words_[w]) return false;
+        return true;
+    }
+
+    bool operator!=(const dynamic_bitset& other) const noexcept { return !(*this == other); }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_t num_words() const noexcept { return words_.size(); }
+
+    // Word w holds bits [64w, 64w + 64), least significant bit first. Code
+    // writing through data() must leave the bits past size() zero.
+    word_type* data() noexcept { return words_.data(); }
+    const word_type* data() const noexcept { return words_.data(); }
+
+private:
+    static constexpr size_t words_for(size_t bits) noexcept {
+        return (bits + bits_per_word - 1) / bits_per_word;
+    }
+
+    static constexpr word_type bit(size_t i) noexcept {
+        return word_type(1) << (i % bits_per_word);
+    }
+
+    void clear_unused_bits() noexcept {
+        if (size_ % bits_per_word != 0)
+            words_[words_.size() - 1] &= ~word_type(0) >> (bits_per_word - size_ % bits_per_word);
+    }
+
+    size_t find_from_word(size_t w) const noexcept {
+        for (; w < words_.size(); ++w)
+            if (words_[w] != 0) return w * bits_per_word + std::countr_zero(words_[w]);
+        return npos;
+    }
+
+    void check_same_size(const dynamic_bitset& other) const {
+        if (size_ != other.size_) throw std::invalid_argument("dynamic_bitset: operands differ in size");
+    }
+};
@@ -0,0 +1,266 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "../flat_set/flat_set.h"
+#include "../vector/vector.h"
+
+// Ordered map stored as a vector of (key, value) pairs sorted by key. Like
+// flat_set it binary-searches contiguous storage and bulk-loads through one
+// append-sort-merge pass. Elements are std::pair<Key, T> rather than
+// pair<const Key, T> so they can be moved around inside the vector; changing
+// a key through an iterator breaks the ordering and is not allowed.
+template <typename Key, typename T, typename Compare = std::less<Key>>
+class flat_map
+{
+public:
+    using value_type = std::pair<Key, T>;
+
+private:
+    using reference = value_type&;
+    using constReference = const value_type&;
+
+public:
+    using Iterator = typename vector<value_type>::Iterator;
+    using ConstIterator = typename vector<value_type>::ConstIterator;
+
+private:
+    struct value_less {
+        Compare comp;
+
+        bool operator()(const value_type& a, const value_type& b) const { return comp(a.first, b.first); }
+    };
+
+    vector<value_type> items_;
+    Compare comp_;
+
+public:
+    flat_map() = default;
+
+    explicit flat_map(const Compare& comp) : comp_(comp) {}
+
+    // Sorts by key; of several items with the same key the first is kept.
+    explicit flat_map(vector<value_type> items, const Compare& comp = Compare())
+        : items_(std::move(items)), comp_(comp) {
+        flat_detail::merge_tail(items_, 0, value_less{comp_}, false);
+    }
+
+    flat_map(sorted_unique_t, vector<value_type> items, const Compare& comp = Compare())
+        : items_(std::move(items)), comp_(comp) {}
+
+    template <typename InputIt>
+    flat_map(InputIt first, InputIt last, const Compare& comp = Compare()) : comp_(comp) {
+        insert(first, last);
+    }
+
+    flat_map(std::initializer_list<value_type> items, const Compare& comp = Compare()) : comp_(comp) {
+        insert(items.begin(), items.end());
+    }
+
+    T& operator[](const Key& key) {
+        return try_emplace(key).first->second;
+    }
+
+    T& operator[](Key&& key) {
+        return try_emplace(std::move(key)).first->second;
+    }
+
+    T& at(const Key& key) {
+        size_t i = find_index(key);
+        if (i == items_.size()) throw std::out_of_range("flat_map: key not found");
+        return items_[i].second;
+    }
+
+    const T& at(const Key& key) const {
+        size_t i = find_index(key);
+        if (i == items_.size()) throw std::out_of_range("flat_map: key not found");
+        return items_[i].second;
+    }
+
+    std::pair<Iterator, bool> insert(const value_type& item) {
+        return try_emplace(item.first, item.second);
+    }
+
+    std::pair<Iterator, bool> insert(value_type&& item) {
+        return try_emplace(std::move(item.first), std::move(item.second));
+    }
+
+    template <typename... Args>
+    std::pair<Iterator, bool> emplace(Args&&... args) {
+        value_type item(std::forward<Args>(args)...);
+        return try_emplace(std::move(item.first), std::move(item.second));
+    }
+
+    // Constructs the value from args only if key is absent.
+    template <typename... Args>
+    std::pair<Iterator, bool> try_emplace(const Key& key, Args&&... args) {
+        return try_emplace_impl(key, std::forward<Args>(args)...);
+    }
+
+    template <typename... Args>
+    std::pair<Iterator, bool> try_emplace(Key&& key, Args&&... args) {
+        return try_emplace_impl(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template <typename M>
+    std::pair<Iterator, bool> insert_or_assign(const Key& key, M&& value) {
+        return insert_or_assign_impl(key, std::forward<M>(value));
+    }
+
+    template <typename M>
+    std::pair<Iterator, bool> insert_or_assign(Key&& key, M&& value) {
+        return insert_or_assign_impl(std::move(key), std::forward<M>(value));
+    }
+
+    // Existing keys keep their values, as with single inserts.
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        size_t old_size = items_.size();
+        append(first, last);
+        flat_detail::merge_tail(items_, old_size, value_less{comp_}, false);
+    }
+
+    // [first, last) must be sorted by key.
+    template <typename InputIt>
+    void insert(sorted_unique_t, InputIt first, InputIt last) {
+        size_t old_size = items_.size();
+        append(first, last);
+        flat_detail::merge_tail(items_, old_size, value_less{comp_}, true);
+    }
+
+    void insert(std::initializer_list<value_type> items) {
+        insert(items.begin(), items.end());
+    }
+
+    Iterator erase(ConstIterator pos) {
+        return items_.erase(pos);
+    }
+
+    Iterator erase(ConstIterator first, ConstIterator last) {
+        return items_.erase(first, last);
+    }
+
+    size_t erase(const Key& key) {
+        size_t i = find_index(key);
+        if (i == items_.size()) return 0;
+
+        items_.erase(items_.cbegin() + i);
+        return 1;
+    }
+
+    Iterator find(const Key& key) { return begin() + find_index(key); }
+    ConstIterator find(const Key& key) const { return begin() + find_index(key); }
+    bool contains(const Key& key) const { return find_index(key) != items_.size(); }
+    size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+    ConstIterator lower_bound(const Key& key) const { return begin() + lower_index(key); }
+    ConstIterator upper_bound(const Key& key) const { return begin() + upper_index(key); }
+
+    template <typename K> requires flat_transparent<Compare>
+    Iterator find(const K& key) { return begin() + find_index(key); }
+
+    template <typename K> requires flat_transparent<Compare>
+    ConstIterator find(const K& key) const { return begin() + find_index(key); }
+
+    template <typename K> requires flat_transparent<Compare>
+    bool contains(const K& key) const { return find_index(key) != items_.size(); }
+
+    template <typename K> requires flat_transparent<Compare>
+    size_t count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    template <typename K> requires flat_transparent<Compare>
+    ConstIterator lower_bound(const K& key) const { return begin() + lower_index(key); }
+
+    template <typename K> requires flat_transparent<Compare>
+    ConstIterator upper_bound(const K& key) const { return begin() + upper_index(key); }
+
+    void reserve(size_t n) { items_.reserve(n); }
+    void shrink_to_fit() { items_.shrink_to_fit(); }
+    void clear() noexcept { items_.clear(); }
+    void swap(flat_map& other) noexcept {
+        items_.swap(other.items_);
+        std::swap(comp_, other.comp_);
+    }
+
+    // Hands the sorted items over, leaving the map empty.
+    vector<value_type> extract() && { return std::move(items_); }
+
+    const vector<value_type>& items() const noexcept { return items_; }
+    Compare key_comp() const { return comp_; }
+
+    size_t size() const noexcept { return items_.size(); }
+    bool empty() const noexcept { return items_.empty(); }
+
+    Iterator begin() noexcept { return items_.begin(); }
+    Iterator end() noexcept { return items_.end(); }
+
+    ConstIterator begin() const noexcept { return items_.begin(); }
+    ConstIterator end() const noexcept { return items_.end(); }
+
+    ConstIterator cbegin() const noexcept { return items_.cbegin(); }
+    ConstIterator cend() const noexcept { return items_.cend(); }
+
+    friend bool operator==(const flat_map& a, const flat_map& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    template <typename K, typename... Args>
+    std::pair<Iterator, bool> try_emplace_impl(K&& key, Args&&... args) {
+        size_t i = lower_index(key);
+        if (i != items_.size() && !comp_(key, items_[i].first)) return {begin() + i, false};
+
+        items_.emplace(items_.cbegin() + i, std::piecewise_construct,
+                       std::forward_as_tuple(std::forward<K>(key)),
+                       std::forward_as_tuple(std::forward<Args>(args)...));
+        return {begin() + i, true};
+    }
+
+    template <typename K, typename M>
+    std::pair<Iterator, bool> insert_or_assign_impl(K&& key, M&& value) {
+        size_t i = lower_index(key);
+        if (i != items_.size() && !comp_(key, items_[i].first)) {
+            items_[i].second = std::forward<M>(value);
+            return {begin() + i, false};
+        }
+
+        items_.emplace(items_.cbegin() + i, std::forward<K>(key), std::forward<M>(value));
+        return {begin() + i, true};
+    }
+
+    template <typename K>
+    size_t lower_index(const K& key) const {
+        const value_type* first = items_.data();
+        return std::lower_bound(first, first + items_.size(), key,
+                                [this](const value_type& item, const K& k) { return comp_(item.first, k); }) - first;
+    }
+
+    template <typename K>
+    size_t upper_index(const K& key) const {
+        const value_type* first = items_.data();
+        return std::upper_bound(first, first + items_.size(), key,
+                                [this](const K& k, const value_type& item) { return comp_(k, item.first); }) - first;
+    }
+
+    // Index of key, or size() when absent.
+    template <typename K>
+    size_t find_index(const K& key) const {
+        size_t i = lower_index(key);
+        return i != items_.size() && !comp_(key, items_[i].first) ? i : items_.size();
+    }
+
+    template <typename InputIt>
+    void append(InputIt first, InputIt last) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+            items_.reserve(items_.size() + std::distance(first, last));
+        for (; first != last; ++first)
+            items_.push_back(*first);
+    }
+};
@@ -0,0 +1,212 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+#include "../vector/vector.h"
+
+// Tag for constructors and insert overloads whose input is already sorted and
+// free of duplicates, so the sort (and for constructors the dedupe) is skipped.
+struct sorted_unique_t {
+    explicit sorted_unique_t() = default;
+};
+
+inline constexpr sorted_unique_t sorted_unique{};
+
+// Lookups accept any K comparable with the key only when the comparator is
+// transparent (std::less<> for instance), following the standard containers.
+template <typename Compare>
+concept flat_transparent = requires { typename Compare::is_transparent; };
+
+struct flat_detail {
+    // v[0, sorted_size) is sorted and unique. Sorts the tail appended after
+    // it, merges the two runs in place and drops duplicates, keeping the
+    // element that was there first. One O(n) pass instead of O(n) per element.
+    template <typename T, typename Less>
+    static void merge_tail(vector<T>& v, size_t sorted_size, Less less, bool tail_sorted) {
+        T* first = v.data();
+        T* mid = first + sorted_size;
+        T* last = first + v.size();
+        if (mid == last) return;
+
+        if (!tail_sorted) std::stable_sort(mid, last, less);
+        std::inplace_merge(first, mid, last, less);
+
+        T* kept = std::unique(first, last, [&less](const T& a, const T& b) { return !less(a, b); });
+        v.erase(v.cbegin() + (kept - first), v.cend());
+    }
+};
+
+// Ordered set stored as a sorted vector. Lookups are binary searches over
+// contiguous keys; single inserts and erases shift the tail, so bulk loads
+// should go through the range insert, which appends and merges once.
+// Iterators are invalidated by any insert or erase.
+template <typename Key, typename Compare = std::less<Key>>
+class flat_set
+{
+    using reference = const Key&;
+    using constReference = const Key&;
+
+public:
+    using Iterator = typename vector<Key>::ConstIterator;
+    using ConstIterator = typename vector<Key>::ConstIterator;
+
+private:
+    vector<Key> keys_;
+    Compare comp_;
+
+public:
+    flat_set() = default;
+
+    explicit flat_set(const Compare& comp) : comp_(comp) {}
+
+    // Sorts and dedupes keys.
+    explicit flat_set(vector<Key> keys, const Compare& comp = Compare())
+        : keys_(std::move(keys)), comp_(comp) {
+        flat_detail::merge_tail(keys_, 0, comp_, false);
+    }
+
+    flat_set(sorted_unique_t, vector<Key> keys, const Compare& comp = Compare())
+        : keys_(std::move(keys)), comp_(comp) {}
+
+    template <typename InputIt>
+    flat_set(InputIt first, InputIt last, const Compare& comp = Compare()) : comp_(comp) {
+        insert(first, last);
+    }
+
+    flat_set(std::initializer_list<Key> keys, const Compare& comp = Compare()) : comp_(comp) {
+        insert(keys.begin(), keys.end());
+    }
+
+    std::pair<Iterator, bool> insert(const Key& key) {
+        return emplace(key);
+    }
+
+    std::pair<Iterator, bool> insert(Key&& key) {
+        return emplace(std::move(key));
+    }
+
+    template <typename... Args>
+    std::pair<Iterator, bool> emplace(Args&&... args) {
+        Key key(std::forward<Args>(args)...);
+        size_t i = lower_index(key);
+        if (i != keys_.size() && !comp_(key, keys_[i])) return {begin() + i, false};
+
+        keys_.insert(keys_.cbegin() + i, std::move(key));
+        return {begin() + i, true};
+    }
+
+    template <typename InputIt>
+    void insert(InputIt first, InputIt last) {
+        size_t old_size = keys_.size();
+        append(first, last);
+        flat_detail::merge_tail(keys_, old_size, comp_, false);
+    }
+
+    // [first, last) must be sorted; duplicates of existing keys are dropped.
+    template <typename InputIt>
+    void insert(sorted_unique_t, InputIt first, InputIt last) {
+        size_t old_size = keys_.size();
+        append(first, last);
+        flat_detail::merge_tail(keys_, old_size, comp_, true);
+    }
+
+    void insert(std::initializer_list<Key> keys) {
+        insert(keys.begin(), keys.end());
+    }
+
+    Iterator erase(ConstIterator pos) {
+        return keys_.erase(pos);
+    }
+
+    Iterator erase(ConstIterator first, ConstIterator last) {
+        return keys_.erase(first, last);
+    }
+
+    size_t erase(const Key& key) {
+        size_t i = find_index(key);
+        if (i == keys_.size()) return 0;
+
+        keys_.erase(keys_.cbegin() + i);
+        return 1;
+    }
+
+    ConstIterator find(const Key& key) const { return begin() + find_index(key); }
+    bool contains(const Key& key) const { return find_index(key) != keys_.size(); }
+    size_t count(const Key& key) const { return contains(key) ? 1 : 0; }
+    ConstIterator lower_bound(const Key& key) const { return begin() + lower_index(key); }
+    ConstIterator upper_bound(const Key& key) const { return begin() + upper_index(key); }
+
+    template <typename K> requires flat_transparent<Compare>
+    ConstIterator find(const K& key) const { return begin() + find_index(key); }
+
+    template <typename K> requires flat_transparent<Compare>
+    bool contains(const K& key) const { return find_index(key) != keys_.size(); }
+
+    template <typename K> requires flat_transparent<Compare>
+    size_t count(const K& key) const { return contains(key) ? 1 : 0; }
+
+    template <typename K> requires flat_transparent<Compare>
+    ConstIterator lower_bound(const K& key) const { return begin() + lower_index(key); }
+
+    template <typename K> requires flat_transparent<Compare>
+    ConstIterator upper_bound(const K& key) const { return begin() + upper_index(key); }
+
+    void reserve(size_t n) { keys_.reserve(n); }
+    void shrink_to_fit() { keys_.shrink_to_fit(); }
+    void clear() noexcept { keys_.clear(); }
+    void swap(flat_set& other) noexcept {
+        keys_.swap(other.keys_);
+        std::swap(comp_, other.comp_);
+    }
+
+    // Hands the sorted keys over, leaving the set empty.
+    vector<Key> extract() && { return std::move(keys_); }
+
+    const vector<Key>& keys() const noexcept { return keys_; }
+    Compare key_comp() const { return comp_; }
+
+    size_t size() const noexcept { return keys_.size(); }
+    bool empty() const noexcept { return keys_.empty(); }
+
+    ConstIterator begin() const noexcept { return keys_.begin(); }
+    ConstIterator end() const noexcept { return keys_.end(); }
+
+    ConstIterator cbegin() const noexcept { return keys_.cbegin(); }
+    ConstIterator cend() const noexcept { return keys_.cend(); }
+
+    friend bool operator==(const flat_set& a, const flat_set& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+
+private:
+    template <typename K>
+    size_t lower_index(const K& key) const {
+        return std::lower_bound(keys_.data(), keys_.data() + keys_.size(), key, comp_) - keys_.data();
+    }
+
+    template <typename K>
+    size_t upper_index(const K& key) const {
+        return std::upper_bound(keys_.data(), keys_.data() + keys_.size(), key, comp_) - keys_.data();
+    }
+
+    // Index of key, or size() when absent.
+    template <typename K>
+    size_t find_index(const K& key) const {
+        size_t i = lower_index(key);
+        return i != keys_.size() && !comp_(key, keys_[i]) ? i : keys_.size();
+    }
+
+    template <typename InputIt>
+    void append(InputIt first, InputIt last) {
+        if constexpr (std::is_base_of_v<std::forward_iterator_tag, typename std::iterator_traits<InputIt>::iterator_category>)
+            keys_.reserve(keys_.size() + std::distance(first, last));
+        for (; first != last; ++first)
+            keys_.push_back(*first);
+    }
+};
@@ -6,6 +6,8 @@
 #include <type_traits>
 #include <limits>
 
+#include "../tracing/memory_usage.h"
+
 template <typename T, typename Allocator = std::allocator<T>>
 class list {
 private:
@@ -289,6 +291,14 @@ public:
     [[nodiscard]] bool empty() const noexcept { return sz == 0; }
     size_type size() const noexcept { return sz; }
     size_type max_size() const noexcept { return NodeAllocTraits::max_size(alloc); }
+
+    // The links and padding of each node are overhead; the sentinel lives
+    // in the list object and is not counted.
+    memory_usage_breakdown memory_breakdown() const noexcept {
+        return {sz * sizeof(T), sz * (sizeof(Node) - sizeof(T)), 0};
+    }
+
+    size_type memory_usage() const noexcept { return sz * sizeof(Node); }
     
     void clear() noexcept {
         NodeBase* curr = sentinel.next;
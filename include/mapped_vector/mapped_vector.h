@@ -0,0 +1,259 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../vector/vector.h"
+
+// vector of trivially copyable records living in a memory-mapped file. The
+// file starts with a 64-byte header holding the element count, followed by
+// the elements themselves, so reopening a file is a single mmap regardless of
+// its size. push_back grows the file geometrically. flush() forces the
+// mapping to disk; without it, the kernel writes pages back on its own.
+template <typename T>
+class mapped_vector
+{
+    static_assert(std::is_trivially_copyable_v<T>, "mapped_vector requires a trivially copyable element type");
+    static_assert(alignof(T) <= 64, "mapped_vector element alignment must not exceed the header size");
+
+    using pointer = T*;
+    using reference = T&;
+    using constReference = const T&;
+
+    struct file_header {
+        uint64_t magic;
+        uint32_t version;
+        uint32_t element_size;
+        uint64_t size;
+        uint64_t reserved[5];
+    };
+
+    static_assert(sizeof(file_header) == 64);
+
+    static constexpr uint64_t file_magic = 0x524f544345564d4dull;
+    static constexpr uint32_t file_version = 1;
+    static constexpr size_t initial_capacity = 4096 / sizeof(T) > 0 ? 4096 / sizeof(T) : 1;
+
+public:
+    using Iterator = typename vector<T>::Iterator;
+    using ConstIterator = typename vector<T>::ConstIterator;
+
+private:
+    int fd_ = -1;
+    unsigned char* map_ = nullptr;
+    size_t map_len_ = 0;
+
+public:
+    mapped_vector() = default;
+
+    explicit mapped_vector(const std::string& path) {
+        open(path);
+    }
+
+    mapped_vector(const mapped_vector&) = delete;
+    mapped_vector& operator=(const mapped_vector&) = delete;
+
+    mapped_vector(mapped_vector&& other) noexcept
+        : fd_(other.fd_), map_(other.map_), map_len_(other.map_len_) {
+        other.fd_ = -1;
+        other.map_ = nullptr;
+        other.map_len_ = 0;
+    }
+
+    mapped_vector& operator=(mapped_vector&& other) noexcept {
+        if (this != &other) {
+            close();
+            std::swap(fd_, other.fd_);
+            std::swap(map_, other.map_);
+            std::swap(map_len_, other.map_len_);
+        }
+        return *this;
+    }
+
+    ~mapped_vector() {
+        close();
+    }
+
+    // On failure the file is closed again and the vector is left closed.
+    void open(const std::string& path) {
+        close();
+        try {
+            open_file(path);
+        } catch (...) {
+            close();
+            throw;
+        }
+    }
+
+    void close() noexcept {
+        if (map_) {
+            ::munmap(map_, map_len_);
+            map_ = nullptr;
+            map_len_ = 0;
+        }
+        if (fd_ >= 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    void flush() {
+        if (map_ && ::msync(map_, map_len_, MS_SYNC) != 0) fail("mapped_vector: msync failed");
+    }
+
+    bool is_open() const noexcept { return map_ != nullptr; }
+
+    void reserve(size_t n) {
+        if (n <= capacity()) return;
+        remap(file_length(n));
+    }
+
+    void shrink_to_fit() {
+        size_t n = size() > 0 ? size() : 1;
+        if (n < capacity()) remap(file_length(n));
+    }
+
+    void push_back(const T& value) {
+        if (full()) grow();
+        data()[header()->size++] = value;
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if (full()) grow();
+        data()[header()->size++] = T(std::forward<Args>(args)...);
+    }
+
+    void pop_back() noexcept {
+        if (size() > 0) --header()->size;
+    }
+
+    void clear() noexcept {
+        if (map_) header()->size = 0;
+    }
+
+    void resize(size_t n) {
+        reserve(n);
+        for (size_t i = size(); i < n; ++i)
+            data()[i] = T();
+        header()->size = n;
+    }
+
+    reference operator[](size_t i) { return data()[i]; }
+    constReference operator[](size_t i) const { return data()[i]; }
+
+    reference at(size_t ind) {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return data()[ind];
+    }
+
+    constReference at(size_t ind) const {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return data()[ind];
+    }
+
+    pointer data() noexcept { return map_ ? reinterpret_cast<pointer>(map_ + sizeof(file_header)) : nullptr; }
+    const T* data() const noexcept { return map_ ? reinterpret_cast<const T*>(map_ + sizeof(file_header)) : nullptr; }
+
+    size_t size() const noexcept { return map_ ? static_cast<size_t>(header()->size) : 0; }
+    size_t capacity() const noexcept { return map_ ? (map_len_ - sizeof(file_header)) / sizeof(T) : 0; }
+    bool empty() const noexcept { return size() == 0; }
+
+    Iterator begin() noexcept { return Iterator(data()); }
+    Iterator end() noexcept { return Iterator(data() + size()); }
+
+    ConstIterator begin() const noexcept { return ConstIterator(data()); }
+    ConstIterator end() const noexcept { return ConstIterator(data() + size()); }
+
+    ConstIterator cbegin() const noexcept { return ConstIterator(data()); }
+    ConstIterator cend() const noexcept { return ConstIterator(data() + size()); }
+
+private:
+    file_header* header() noexcept { return reinterpret_cast<file_header*>(map_); }
+    const file_header* header() const noexcept { return reinterpret_cast<const file_header*>(map_); }
+
+    static size_t file_length(size_t n) noexcept { return sizeof(file_header) + n * sizeof(T); }
+
+    bool full() const noexcept { return size() == capacity(); }
+
+    void grow() {
+        if (!map_) throw std::logic_error("mapped_vector: no file is open");
+        remap(file_length(capacity() == 0 ? initial_capacity : 2 * capacity()));
+    }
+
+    void open_file(const std::string& path) {
+        fd_ = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+        if (fd_ < 0) fail("mapped_vector: cannot open ", path);
+
+        struct stat st;
+        if (::fstat(fd_, &st) != 0) fail("mapped_vector: cannot stat ", path);
+
+        size_t len = static_cast<size_t>(st.st_size);
+        if (len == 0) {
+            len = file_length(initial_capacity);
+            if (::ftruncate(fd_, static_cast<off_t>(len)) != 0) fail("mapped_vector: cannot size ", path);
+            map(len);
+            *header() = file_header{file_magic, file_version, sizeof(T), 0, {}};
+            return;
+        }
+
+        if (len < sizeof(file_header)) throw std::runtime_error("mapped_vector: " + path + " is too short");
+        map(len);
+
+        const file_header* h = header();
+        if (h->magic != file_magic || h->version != file_version)
+            throw std::runtime_error("mapped_vector: " + path + " is not a mapped_vector file");
+        if (h->element_size != sizeof(T))
+            throw std::runtime_error("mapped_vector: " + path + " holds elements of a different size");
+        if (h->size > capacity())
+            throw std::runtime_error("mapped_vector: " + path + " is truncated");
+    }
+
+    void map(size_t len) {
+        void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+        if (p == MAP_FAILED) fail("mapped_vector: mmap failed");
+        map_ = static_cast<unsigned char*>(p);
+        map_len_ = len;
+    }
+
+    void remap(size_t len) {
+        if (!map_) throw std::logic_error("mapped_vector: no file is open");
+
+        size_t old_len = map_len_;
+        if (len > old_len && ::ftruncate(fd_, static_cast<off_t>(len)) != 0)
+            fail("mapped_vector: cannot grow file");
+
+#if defined(__linux__)
+        void* p = ::mremap(map_, old_len, len, MREMAP_MAYMOVE);
+        if (p == MAP_FAILED) fail("mapped_vector: mremap failed");
+        map_ = static_cast<unsigned char*>(p);
+        map_len_ = len;
+#else
+        ::munmap(map_, old_len);
+        map_ = nullptr;
+        map(len);
+#endif
+
+        if (len < old_len && ::ftruncate(fd_, static_cast<off_t>(len)) != 0)
+            fail("mapped_vector: cannot shrink file");
+    }
+
+    // errno is read before the message is built, since allocating it may
+    // overwrite errno.
+    [[noreturn]] static void fail(const char* what, const std::string& path = std::string()) {
+        int err = errno;
+        throw std::system_error(err, std::generic_category(), what + path);
+    }
+};
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include "../vector/vector.h"
+#include "packed_vector.h"
+
+// Append-only vector of non-decreasing unsigned integers (sorted IDs,
+// offsets, timestamps) stored as bit-packed gaps. Each block of 128 keeps
+// its first value and the differences between neighbours at the smallest
+// width that fits the largest gap, so dense sorted IDs take a few bits each.
+// Reading an element decodes its block; lower_bound binary-searches the
+// block heads first and decodes a single block. The last partial block is
+// kept uncompressed until it fills up.
+template <typename T = uint64_t>
+class delta_vector
+{
+    static_assert(std::is_unsigned_v<T> && sizeof(T) <= 8, "delta_vector stores unsigned integers of up to 64 bits");
+
+    static constexpr size_t block_size = bitpack::block_size;
+
+    struct block_info {
+        uint64_t first;
+        uint64_t offset_width;  // word offset << 8 | bit width
+
+        size_t offset() const noexcept { return offset_width >> 8; }
+        unsigned width() const noexcept { return offset_width & 0xFF; }
+    };
+
+    vector<block_info> blocks_;
+    vector<uint64_t> words_;  // packed blocks, then one padding word
+    vector<T> tail_;
+    T last_ = 0;
+
+public:
+    delta_vector() = default;
+
+    explicit delta_vector(std::span<const T> values) {
+        for (T value : values)
+            push_back(value);
+    }
+
+    void push_back(T value) {
+        if (!empty() && value < last_) throw std::invalid_argument("delta_vector: values must be non-decreasing");
+
+        tail_.push_back(value);
+        last_ = value;
+        if (tail_.size() == block_size) seal_tail();
+    }
+
+    T operator[](size_t i) const {
+        size_t b = i / block_size;
+        if (b == blocks_.size()) return tail_[i % block_size];
+
+        const block_info& info = blocks_[b];
+        const uint64_t* words = words_.data() + info.offset();
+        uint64_t value = info.first;
+        for (size_t j = 1, n = i % block_size; j <= n; ++j)
+            value += bitpack::get(words, info.width(), j);
+        return static_cast<T>(value);
+    }
+
+    T at(size_t ind) const {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return (*this)[ind];
+    }
+
+    T front() const { return (*this)[0]; }
+    T back() const { return last_; }
+
+    // Writes the values of block b (block_values(b) of them) to out.
+    void decode_block(size_t b, T* out) const {
+        if (b == blocks_.size()) {
+            for (size_t i = 0; i < tail_.size(); ++i)
+                out[i] = tail_[i];
+            return;
+        }
+
+        const block_info& info = blocks_[b];
+        uint64_t gaps[block_size];
+        bitpack::unpack(words_.data() + info.offset(), info.width(), 0, gaps);
+
+        uint64_t value = info.first;
+        for (size_t i = 0; i < block_size; ++i) {
+            value += gaps[i];
+            out[i] = static_cast<T>(value);
+        }
+    }
+
+    // Calls f(value) for every element in order, a block at a time.
+    template <typename F>
+    void for_each(F f) const {
+        T buffer[block_size];
+        for (size_t b = 0; b < num_blocks(); ++b) {
+            decode_block(b, buffer);
+            for (size_t i = 0, n = block_values(b); i < n; ++i)
+                f(buffer[i]);
+        }
+    }
+
+    // Index of the first element not less than value, or size().
+    size_t lower_bound(T value) const {
+        size_t lo = 0, hi = num_blocks();
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (block_first(mid) < value) lo = mid + 1;
+            else hi = mid;
+        }
+        // Block lo starts at or after value, so the answer is in block lo - 1
+        // or is the first element of block lo.
+        if (lo == 0) return 0;
+
+        T buffer[block_size];
+        size_t b = lo - 1;
+        decode_block(b, buffer);
+        size_t n = block_values(b);
+        return b * block_size + (std::lower_bound(buffer, buffer + n, value) - buffer);
+    }
+
+    bool contains(T value) const {
+        size_t i = lower_bound(value);
+        return i != size() && (*this)[i] == value;
+    }
+
+    void clear() noexcept {
+        blocks_.clear();
+        words_.clear();
+        tail_.clear();
+        last_ = 0;
+    }
+
+    void shrink_to_fit() {
+        blocks_.shrink_to_fit();
+        words_.shrink_to_fit();
+    }
+
+    size_t size() const noexcept { return blocks_.size() * block_size + tail_.size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    // Blocks including the uncompressed tail, if any.
+    size_t num_blocks() const noexcept { return blocks_.size() + (tail_.size() > 0); }
+    size_t block_values(size_t b) const noexcept { return b < blocks_.size() ? block_size : tail_.size(); }
+
+    size_t memory_bytes() const noexcept {
+        return blocks_.capacity() * sizeof(block_info) + words_.capacity() * sizeof(uint64_t) +
+               tail_.capacity() * sizeof(T);
+    }
+
+private:
+    T block_first(size_t b) const noexcept {
+        return b < blocks_.size() ? static_cast<T>(blocks_[b].first) : tail_[0];
+    }
+
+    // The first gap is always zero, which keeps the block layout identical
+    // to packed_vector's and lets decode start from the stored first value.
+    void seal_tail() {
+        uint64_t gaps[block_size];
+        gaps[0] = 0;
+        uint64_t widest = 0;
+        for (size_t i = 1; i < block_size; ++i) {
+            gaps[i] = uint64_t(tail_[i]) - tail_[i - 1];
+            widest |= gaps[i];
+        }
+
+        unsigned width = std::bit_width(widest);
+        size_t offset = words_.empty() ? 0 : words_.size() - 1;
+        words_.resize(offset + bitpack::words_for(width) + 1, 0);
+        bitpack::pack(gaps, width, words_.data() + offset);
+
+        blocks_.push_back(block_info{tail_[0], uint64_t(offset) << 8 | width});
+        tail_.clear();
+    }
+};
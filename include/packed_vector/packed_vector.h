@@ -0,0 +1,272 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../vector/vector.h"
+
+// Bit-packing kernels shared by packed_vector and delta_vector. A block is
+// 128 values stored at a common bit width w in 2w words. unpack is
+// instantiated once per width and fully unrolled, so every shift and mask is
+// a constant and a scan decodes faster than it could stream raw 64-bit words.
+struct bitpack {
+private:
+    using unpack_fn = void (*)(const uint64_t*, uint64_t, uint64_t*);
+
+    template <unsigned W>
+    static void unpack_width(const uint64_t* in, uint64_t base, uint64_t* out) noexcept {
+        if constexpr (W == 0) {
+            for (size_t i = 0; i < block_size; ++i)
+                out[i] = base;
+        } else {
+            // 64 values at width W fill exactly W words, so both halves of
+            // the block share one shift pattern.
+            for (size_t half = 0; half < 2; ++half, in += W, out += 64) {
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC unroll 64
+#endif
+                for (size_t i = 0; i < 64; ++i) {
+                    size_t bit = i * W;
+                    size_t word = bit / 64;
+                    unsigned shift = bit % 64;
+                    uint64_t v = in[word] >> shift;
+                    if (shift + W > 64) v |= in[word + 1] << (64 - shift);
+                    out[i] = base + (v & mask(W));
+                }
+            }
+        }
+    }
+
+    template <size_t... W>
+    static constexpr std::array<unpack_fn, sizeof...(W)> make_table(std::index_sequence<W...>) {
+        return {&unpack_width<W>...};
+    }
+
+public:
+    static constexpr size_t block_size = 128;
+
+    // A constant block still gets one zero word so get() stays in bounds.
+    static constexpr size_t words_for(unsigned width) noexcept { return width == 0 ? 1 : 2 * width; }
+
+    static constexpr uint64_t mask(unsigned width) noexcept {
+        return width == 0 ? 0 : ~uint64_t(0) >> (64 - width);
+    }
+
+    // out must hold words_for(width) zeroed words.
+    static void pack(const uint64_t* in, unsigned width, uint64_t* out) noexcept {
+        if (width == 0) return;
+
+        for (size_t i = 0; i < block_size; ++i) {
+            size_t bit = i * width;
+            size_t word = bit / 64;
+            unsigned shift = bit % 64;
+            out[word] |= in[i] << shift;
+            if (shift + width > 64) out[word + 1] |= in[i] >> (64 - shift);
+        }
+    }
+
+    // Value i of a block at width w. Reads two words without branching, so
+    // the storage needs one readable word past the last block.
+    static uint64_t get(const uint64_t* in, unsigned width, size_t i) noexcept {
+        size_t bit = i * width;
+        size_t word = bit / 64;
+        unsigned shift = bit % 64;
+        uint64_t lo = in[word] >> shift;
+        uint64_t hi = (in[word + 1] << 1) << (63 - shift);
+        return (lo | hi) & mask(width);
+    }
+
+    // out[i] = base + value i, for the whole block.
+    static void unpack(const uint64_t* in, unsigned width, uint64_t base, uint64_t* out) noexcept {
+        static constexpr auto table = make_table(std::make_index_sequence<65>());
+        table[width](in, base, out);
+    }
+};
+
+// Append-only vector of unsigned integers compressed with frame of
+// reference: each block of 128 values stores its minimum and packs the
+// differences at the smallest width that fits them. operator[] is O(1) (one
+// metadata load and a two-word read); for_each and decode_block unpack whole
+// blocks. The last partial block is kept uncompressed until it fills up.
+template <typename T = uint64_t>
+class packed_vector
+{
+    static_assert(std::is_unsigned_v<T> && sizeof(T) <= 8, "packed_vector stores unsigned integers of up to 64 bits");
+
+    static constexpr size_t block_size = bitpack::block_size;
+
+    struct block_info {
+        uint64_t base;
+        uint64_t offset_width;  // word offset << 8 | bit width
+
+        size_t offset() const noexcept { return offset_width >> 8; }
+        unsigned width() const noexcept { return offset_width & 0xFF; }
+    };
+
+public:
+    class ConstIterator {
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using reference = T;
+
+    private:
+        const packed_vector* vec_;
+        size_t index_;
+
+    public:
+        ConstIterator() : vec_(nullptr), index_(0) {}
+        ConstIterator(const packed_vector* vec, size_t index) : vec_(vec), index_(index) {}
+
+        reference operator*() const { return (*vec_)[index_]; }
+        reference operator[](difference_type n) const { return (*vec_)[index_ + n]; }
+
+        ConstIterator& operator++() { ++index_; return *this; }
+        ConstIterator operator++(int) { ConstIterator temp = *this; ++index_; return temp; }
+        ConstIterator& operator--() { --index_; return *this; }
+        ConstIterator operator--(int) { ConstIterator temp = *this; --index_; return temp; }
+
+        ConstIterator& operator+=(difference_type n) { index_ += n; return *this; }
+        ConstIterator& operator-=(difference_type n) { index_ -= n; return *this; }
+
+        ConstIterator operator+(difference_type n) const { return ConstIterator(vec_, index_ + n); }
+        ConstIterator operator-(difference_type n) const { return ConstIterator(vec_, index_ - n); }
+        difference_type operator-(const ConstIterator& other) const {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        friend ConstIterator operator+(difference_type n, const ConstIterator& it) { return it + n; }
+
+        bool operator==(const ConstIterator& other) const { return index_ == other.index_; }
+        bool operator!=(const ConstIterator& other) const { return index_ != other.index_; }
+        bool operator<(const ConstIterator& other) const { return index_ < other.index_; }
+        bool operator>(const ConstIterator& other) const { return index_ > other.index_; }
+        bool operator<=(const ConstIterator& other) const { return index_ <= other.index_; }
+        bool operator>=(const ConstIterator& other) const { return index_ >= other.index_; }
+    };
+
+    using Iterator = ConstIterator;
+
+private:
+    vector<block_info> blocks_;
+    vector<uint64_t> words_;  // packed blocks, then one padding word
+    vector<T> tail_;
+
+public:
+    packed_vector() = default;
+
+    explicit packed_vector(std::span<const T> values) {
+        for (T value : values)
+            push_back(value);
+    }
+
+    void push_back(T value) {
+        tail_.push_back(value);
+        if (tail_.size() == block_size) seal_tail();
+    }
+
+    T operator[](size_t i) const {
+        size_t b = i / block_size;
+        if (b == blocks_.size()) return tail_[i % block_size];
+
+        const block_info& info = blocks_[b];
+        return static_cast<T>(info.base + bitpack::get(words_.data() + info.offset(), info.width(), i % block_size));
+    }
+
+    T at(size_t ind) const {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return (*this)[ind];
+    }
+
+    T front() const { return (*this)[0]; }
+    T back() const { return (*this)[size() - 1]; }
+
+    // Writes the values of block b (block_values(b) of them) to out.
+    void decode_block(size_t b, T* out) const {
+        if (b == blocks_.size()) {
+            for (size_t i = 0; i < tail_.size(); ++i)
+                out[i] = tail_[i];
+            return;
+        }
+
+        const block_info& info = blocks_[b];
+        if constexpr (std::is_same_v<T, uint64_t>) {
+            bitpack::unpack(words_.data() + info.offset(), info.width(), info.base, out);
+        } else {
+            uint64_t buffer[block_size];
+            bitpack::unpack(words_.data() + info.offset(), info.width(), info.base, buffer);
+            for (size_t i = 0; i < block_size; ++i)
+                out[i] = static_cast<T>(buffer[i]);
+        }
+    }
+
+    // Calls f(value) for every element in order, a block at a time.
+    template <typename F>
+    void for_each(F f) const {
+        T buffer[block_size];
+        for (size_t b = 0; b < num_blocks(); ++b) {
+            decode_block(b, buffer);
+            for (size_t i = 0, n = block_values(b); i < n; ++i)
+                f(buffer[i]);
+        }
+    }
+
+    void clear() noexcept {
+        blocks_.clear();
+        words_.clear();
+        tail_.clear();
+    }
+
+    void shrink_to_fit() {
+        blocks_.shrink_to_fit();
+        words_.shrink_to_fit();
+    }
+
+    size_t size() const noexcept { return blocks_.size() * block_size + tail_.size(); }
+    bool empty() const noexcept { return size() == 0; }
+
+    // Blocks including the uncompressed tail, if any.
+    size_t num_blocks() const noexcept { return blocks_.size() + (tail_.size() > 0); }
+    size_t block_values(size_t b) const noexcept { return b < blocks_.size() ? block_size : tail_.size(); }
+
+    size_t memory_bytes() const noexcept {
+        return blocks_.capacity() * sizeof(block_info) + words_.capacity() * sizeof(uint64_t) +
+               tail_.capacity() * sizeof(T);
+    }
+
+    ConstIterator begin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator end() const noexcept { return ConstIterator(this, size()); }
+
+    ConstIterator cbegin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator cend() const noexcept { return ConstIterator(this, size()); }
+
+private:
+    void seal_tail() {
+        uint64_t lo = tail_[0], hi = tail_[0];
+        for (size_t i = 1; i < block_size; ++i) {
+            if (tail_[i] < lo) lo = tail_[i];
+            if (hi < tail_[i]) hi = tail_[i];
+        }
+
+        uint64_t deltas[block_size];
+        for (size_t i = 0; i < block_size; ++i)
+            deltas[i] = tail_[i] - lo;
+
+        unsigned width = std::bit_width(hi - lo);
+        size_t offset = words_.empty() ? 0 : words_.size() - 1;
+        words_.resize(offset + bitpack::words_for(width) + 1, 0);
+        bitpack::pack(deltas, width, words_.data() + offset);
+
+        blocks_.push_back(block_info{lo, uint64_t(offset) << 8 | width});
+        tail_.clear();
+    }
+};
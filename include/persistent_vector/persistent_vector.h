@@ -0,0 +1,810 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <utility>
+
+// Tree shared by persistent_vector and transient_vector: a 32-way relaxed
+// radix balanced (RRB) tree holding all but the last elements, plus a tail
+// leaf with the last up to 32. Nodes are reference counted and shared
+// between versions. A write copies the nodes it touches that are shared and
+// changes the unshared ones in place, so copying a tree and writing to the
+// copy copies just the path to the change (log32 n nodes).
+//
+// Nodes stay regular (child i covers indices [i << shift, (i + 1) << shift),
+// found with a shift and a mask) until concatenation leaves partly filled
+// nodes inside the tree; such nodes carry a table of cumulative child sizes
+// and are searched starting from the radix guess. Concatenation rebalances
+// the nodes along the seam so a lookup makes at most a couple of extra steps
+// per level.
+template <typename T>
+class rrb_tree
+{
+public:
+    static constexpr unsigned bits = 5;
+    static constexpr size_t branching = size_t(1) << bits;
+
+private:
+    static constexpr size_t extra_steps = 2;
+
+    struct node {
+        std::atomic<uint32_t> refs{1};
+        uint32_t count = 0;  // elements of a leaf, children of an inner node
+    };
+
+    struct leaf : node {
+        alignas(T) unsigned char bytes[branching * sizeof(T)];
+
+        T* values() noexcept { return reinterpret_cast<T*>(bytes); }
+        const T* values() const noexcept { return reinterpret_cast<const T*>(bytes); }
+    };
+
+    struct inner : node {
+        size_t* sizes = nullptr;  // cumulative subtree sizes when relaxed
+        node* children[branching];
+    };
+
+    // A reference released when it goes out of scope unless taken.
+    struct owned {
+        node* n;
+        unsigned shift;
+
+        ~owned() { release(n, shift); }
+        node* take() noexcept { return std::exchange(n, nullptr); }
+    };
+
+    // References to sibling nodes gathered while concatenating.
+    struct node_list {
+        node* items[3 * branching];
+        size_t count = 0;
+        unsigned shift;
+
+        explicit node_list(unsigned s) : shift(s) {}
+        ~node_list() {
+            for (size_t i = 0; i < count; ++i)
+                release(items[i], shift);
+        }
+
+        void push(node* n) noexcept { items[count++] = n; }
+    };
+
+    node* root_ = nullptr;  // elements before the tail; null if there are none
+    unsigned shift_ = 0;    // root height times bits, 0 when the root is a leaf
+    leaf* tail_ = nullptr;
+    size_t size_ = 0;
+
+public:
+    rrb_tree() = default;
+
+    rrb_tree(const rrb_tree& other) noexcept
+        : root_(retain(other.root_)), shift_(other.shift_), tail_(retain(other.tail_)), size_(other.size_) {}
+
+    rrb_tree(rrb_tree&& other) noexcept
+        : root_(std::exchange(other.root_, nullptr)), shift_(std::exchange(other.shift_, 0)),
+          tail_(std::exchange(other.tail_, nullptr)), size_(std::exchange(other.size_, 0)) {}
+
+    rrb_tree& operator=(rrb_tree other) noexcept {
+        swap(other);
+        return *this;
+    }
+
+    ~rrb_tree() {
+        release(root_, shift_);
+        release(tail_, 0);
+    }
+
+    void swap(rrb_tree& other) noexcept {
+        std::swap(root_, other.root_);
+        std::swap(shift_, other.shift_);
+        std::swap(tail_, other.tail_);
+        std::swap(size_, other.size_);
+    }
+
+    size_t size() const noexcept { return size_; }
+
+    // Elements of the leaf holding index i; start receives the index of its
+    // first element and end one past its last.
+    const T* leaf_for(size_t i, size_t& start, size_t& end) const noexcept {
+        size_t offset = tail_offset();
+        if (i >= offset) {
+            start = offset;
+            end = size_;
+            return tail_->values();
+        }
+
+        const node* n = root_;
+        size_t r = i;
+        for (unsigned shift = shift_; shift > 0; shift -= bits) {
+            const inner* in = static_cast<const inner*>(n);
+            n = in->children[child_index(in, shift, r)];
+        }
+        start = i - r;
+        end = start + n->count;
+        return static_cast<const leaf*>(n)->values();
+    }
+
+    const T& get(size_t i) const noexcept {
+        size_t start, end;
+        return leaf_for(i, start, end)[i - start];
+    }
+
+    // Element i after copying whatever on its path is shared.
+    T& get_mutable(size_t i) {
+        if (i >= tail_offset()) {
+            make_unique(tail_, 0);
+            return tail_->values()[i - tail_offset()];
+        }
+
+        node** slot = &root_;
+        size_t r = i;
+        for (unsigned shift = shift_;; shift -= bits) {
+            make_unique(*slot, shift);
+            if (shift == 0) return static_cast<leaf*>(*slot)->values()[r];
+
+            inner* in = static_cast<inner*>(*slot);
+            slot = &in->children[child_index(in, shift, r)];
+        }
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if (!tail_) {
+            tail_ = new_leaf();
+        } else if (tail_->count == branching) {
+            leaf* fresh = new_leaf();
+            try {
+                push_leaf(retain(tail_));
+            } catch (...) {
+                release(fresh, 0);
+                throw;
+            }
+            release(tail_, 0);
+            tail_ = fresh;
+        } else {
+            make_unique(tail_, 0);
+        }
+
+        std::construct_at(tail_->values() + tail_->count, std::forward<Args>(args)...);
+        ++tail_->count;
+        ++size_;
+    }
+
+    // Appends the elements of other, sharing its nodes.
+    void append(const rrb_tree& other) {
+        if (other.size_ == 0) return;
+        if (size_ == 0) {
+            *this = other;
+            return;
+        }
+        if (!other.root_) {
+            for (uint32_t i = 0; i < other.tail_->count; ++i)
+                emplace_back(other.tail_->values()[i]);
+            return;
+        }
+
+        // The tail, full or not, becomes the last leaf of the tree.
+        if (tail_) {
+            push_leaf(retain(tail_));
+            release(tail_, 0);
+            tail_ = nullptr;
+        }
+
+        unsigned shift;
+        node* root = concat(retain(root_), shift_, retain(other.root_), other.shift_, true, shift);
+        release(root_, shift_);
+        root_ = root;
+        shift_ = shift;
+        tail_ = retain(other.tail_);
+        size_ += other.size_;
+
+        while (shift_ > 0 && root_->count == 1) {
+            node* child = retain(static_cast<inner*>(root_)->children[0]);
+            release(root_, shift_);
+            root_ = child;
+            shift_ -= bits;
+        }
+    }
+
+    // Calls f(values, count) for each leaf in order.
+    template <typename F>
+    void for_each_leaf(F& f) const {
+        if (root_) walk(root_, shift_, f);
+        if (tail_) f(static_cast<const T*>(tail_->values()), size_t(tail_->count));
+    }
+
+private:
+    size_t tail_offset() const noexcept { return tail_ ? size_ - tail_->count : size_; }
+
+    template <typename N>
+    static N* retain(N* n) noexcept {
+        if (n) n->refs.fetch_add(1, std::memory_order_relaxed);
+        return n;
+    }
+
+    static void release(node* n, unsigned shift) noexcept {
+        if (!n || n->refs.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+
+        if (shift == 0) {
+            leaf* l = static_cast<leaf*>(n);
+            std::destroy_n(l->values(), l->count);
+            delete l;
+        } else {
+            inner* in = static_cast<inner*>(n);
+            for (uint32_t i = 0; i < in->count; ++i)
+                release(in->children[i], shift - bits);
+            delete[] in->sizes;
+            delete in;
+        }
+    }
+
+    static leaf* new_leaf() { return new leaf; }
+    static inner* new_inner() { return new inner; }
+
+    static node* copy(const node* n, unsigned shift) {
+        if (shift == 0) {
+            const leaf* src = static_cast<const leaf*>(n);
+            owned holder{new_leaf(), 0};
+            leaf* dst = static_cast<leaf*>(holder.n);
+            for (; dst->count < src->count; ++dst->count)
+                std::construct_at(dst->values() + dst->count, src->values()[dst->count]);
+            return holder.take();
+        }
+
+        const inner* src = static_cast<const inner*>(n);
+        inner* dst = new_inner();
+        if (src->sizes) {
+            try {
+                dst->sizes = new size_t[branching];
+            } catch (...) {
+                delete dst;
+                throw;
+            }
+            std::copy_n(src->sizes, src->count, dst->sizes);
+        }
+        for (uint32_t i = 0; i < src->count; ++i)
+            dst->children[i] = retain(src->children[i]);
+        dst->count = src->count;
+        return dst;
+    }
+
+    // A count of 1 cannot rise under us: n is reachable only through nodes
+    // that are themselves unshared.
+    template <typename N>
+    static void make_unique(N*& n, unsigned shift) {
+        if (n->refs.load(std::memory_order_acquire) == 1) return;
+
+        N* fresh = static_cast<N*>(copy(n, shift));
+        release(n, shift);
+        n = fresh;
+    }
+
+    // Index of the child of in that holds relative index r, which becomes
+    // relative to that child. Each child covers at most 1 << shift indices,
+    // so r >> shift never overshoots in a relaxed node.
+    static size_t child_index(const inner* in, unsigned shift, size_t& r) noexcept {
+        size_t idx = r >> shift;
+        if (in->sizes) {
+            while (in->sizes[idx] <= r)
+                ++idx;
+            if (idx > 0) r -= in->sizes[idx - 1];
+        } else {
+            r -= idx << shift;
+        }
+        return idx;
+    }
+
+    static size_t size_of(const node* n, unsigned shift) noexcept {
+        if (shift == 0) return n->count;
+
+        const inner* in = static_cast<const inner*>(n);
+        if (in->sizes) return in->sizes[in->count - 1];
+        return (size_t(in->count - 1) << shift) + size_of(in->children[in->count - 1], shift - bits);
+    }
+
+    static bool has_room(const node* n, unsigned shift) noexcept {
+        if (shift == 0) return false;
+
+        const inner* in = static_cast<const inner*>(n);
+        return in->count < branching || has_room(in->children[in->count - 1], shift - bits);
+    }
+
+    // Makes in regular when every child but the last is full, and relaxed
+    // with a size table otherwise.
+    static void set_sizes(inner* in, unsigned shift) {
+        bool regular = true;
+        for (uint32_t i = 0; i + 1 < in->count && regular; ++i)
+            regular = size_of(in->children[i], shift - bits) == size_t(1) << shift;
+
+        if (regular) {
+            delete[] in->sizes;
+            in->sizes = nullptr;
+            return;
+        }
+
+        if (!in->sizes) in->sizes = new size_t[branching];
+        size_t sum = 0;
+        for (uint32_t i = 0; i < in->count; ++i) {
+            sum += size_of(in->children[i], shift - bits);
+            in->sizes[i] = sum;
+        }
+    }
+
+    // Wraps n in single-child nodes from height from up to height to.
+    // Consumes the reference to n, also when it throws.
+    static node* path(node* n, unsigned from, unsigned to) {
+        owned holder{n, from};
+        for (; holder.shift < to; holder.shift += bits) {
+            inner* parent = new_inner();
+            parent->children[0] = holder.take();
+            parent->count = 1;
+            holder.n = parent;
+        }
+        return holder.take();
+    }
+
+    // Adds leaf l after the last element of the tree. Consumes the
+    // reference to l, also when it throws.
+    void push_leaf(leaf* l) {
+        if (!root_) {
+            root_ = l;
+            shift_ = 0;
+            return;
+        }
+        if (has_room(root_, shift_)) {
+            append_leaf(root_, shift_, l);
+            return;
+        }
+
+        owned branch{path(l, 0, shift_), shift_};
+        inner* top = new_inner();
+        top->children[0] = retain(root_);
+        top->children[1] = branch.take();
+        top->count = 2;
+        owned holder{top, shift_ + bits};
+        set_sizes(top, shift_ + bits);
+
+        release(root_, shift_);
+        root_ = holder.take();
+        shift_ += bits;
+    }
+
+    void append_leaf(node*& n, unsigned shift, leaf* l) {
+        owned holder{l, 0};
+        make_unique(n, shift);
+        inner* in = static_cast<inner*>(n);
+        node*& last = in->children[in->count - 1];
+
+        if (shift > bits && has_room(last, shift - bits)) {
+            size_t added = l->count;
+            append_leaf(last, shift - bits, static_cast<leaf*>(holder.take()));
+            if (in->sizes) in->sizes[in->count - 1] += added;
+            return;
+        }
+
+        size_t* sizes = nullptr;
+        if (!in->sizes && size_of(last, shift - bits) != size_t(1) << shift) {
+            sizes = new size_t[branching];
+            for (uint32_t i = 0; i + 1 < in->count; ++i)
+                sizes[i] = size_t(i + 1) << shift;
+            sizes[in->count - 1] = (size_t(in->count - 1) << shift) + size_of(last, shift - bits);
+        }
+
+        size_t added = l->count;
+        node* branch;
+        try {
+            branch = path(holder.take(), 0, shift - bits);
+        } catch (...) {
+            delete[] sizes;
+            throw;
+        }
+
+        if (sizes) in->sizes = sizes;
+        if (in->sizes) in->sizes[in->count] = in->sizes[in->count - 1] + added;
+        in->children[in->count++] = branch;
+    }
+
+    // Joins two trees into one whose height is at most one above the taller,
+    // merging the nodes along the seam. Consumes both references. The
+    // result is a node one level above max(ls, rs) except at the top, where
+    // result_shift gives its height.
+    static node* concat(node* left, unsigned ls, node* right, unsigned rs, bool top, unsigned& result_shift) {
+        owned l{left, ls}, r{right, rs};
+
+        if (ls > rs) {
+            inner* li = static_cast<inner*>(left);
+            unsigned s;
+            node* centre = concat(retain(li->children[li->count - 1]), ls - bits, r.take(), rs, false, s);
+            return rebalance(li, centre, nullptr, ls, top, result_shift);
+        }
+        if (ls < rs) {
+            inner* ri = static_cast<inner*>(right);
+            unsigned s;
+            node* centre = concat(l.take(), ls, retain(ri->children[0]), rs - bits, false, s);
+            return rebalance(nullptr, centre, ri, rs, top, result_shift);
+        }
+
+        if (ls == 0) {
+            leaf* a = static_cast<leaf*>(left);
+            leaf* b = static_cast<leaf*>(right);
+            if (top && a->count + b->count <= branching) {
+                owned holder{new_leaf(), 0};
+                leaf* merged = static_cast<leaf*>(holder.n);
+                for (const leaf* src : {a, b})
+                    for (uint32_t i = 0; i < src->count; ++i, ++merged->count)
+                        std::construct_at(merged->values() + merged->count, src->values()[i]);
+                result_shift = 0;
+                return holder.take();
+            }
+
+            inner* parent = new_inner();
+            parent->children[0] = l.take();
+            parent->children[1] = r.take();
+            parent->count = 2;
+            owned holder{parent, bits};
+            set_sizes(parent, bits);
+            result_shift = bits;
+            return holder.take();
+        }
+
+        inner* li = static_cast<inner*>(left);
+        inner* ri = static_cast<inner*>(right);
+        unsigned s;
+        node* centre = concat(retain(li->children[li->count - 1]), ls - bits, retain(ri->children[0]), rs - bits, false, s);
+        return rebalance(li, centre, ri, ls, top, result_shift);
+    }
+
+    // Regroups the children of left (but its last), centre and right (but
+    // its first) so that there are at most extra_steps more nodes than the
+    // minimum, copying only the nodes that are not already nearly full.
+    static node* rebalance(const inner* left, node* centre, const inner* right, unsigned shift, bool top,
+                           unsigned& result_shift) {
+        owned c{centre, shift};
+        node_list all(shift - bits);
+        if (left)
+            for (uint32_t i = 0; i + 1 < left->count; ++i)
+                all.push(retain(left->children[i]));
+        const inner* ci = static_cast<const inner*>(centre);
+        for (uint32_t i = 0; i < ci->count; ++i)
+            all.push(retain(ci->children[i]));
+        if (right)
+            for (uint32_t i = 1; i < right->count; ++i)
+                all.push(retain(right->children[i]));
+
+        size_t plan[3 * branching];
+        size_t planned = make_plan(all, plan);
+        node_list merged(shift - bits);
+        execute_plan(all, plan, planned, merged);
+
+        if (planned <= branching) {
+            owned holder{take_children(merged, 0, planned, shift), shift};
+            if (top) {
+                result_shift = shift;
+                return holder.take();
+            }
+            result_shift = shift + bits;
+            return path(holder.take(), shift, shift + bits);
+        }
+
+        owned first{take_children(merged, 0, branching, shift), shift};
+        owned second{take_children(merged, branching, planned, shift), shift};
+        inner* parent = new_inner();
+        parent->children[0] = first.take();
+        parent->children[1] = second.take();
+        parent->count = 2;
+        owned holder{parent, shift + bits};
+        set_sizes(parent, shift + bits);
+        result_shift = shift + bits;
+        return holder.take();
+    }
+
+    static size_t make_plan(const node_list& all, size_t* plan) noexcept {
+        size_t total = 0;
+        for (size_t i = 0; i < all.count; ++i) {
+            plan[i] = all.items[i]->count;
+            total += plan[i];
+        }
+
+        size_t optimal = (total + branching - 1) / branching;
+        size_t n = all.count;
+        size_t i = 0;
+        while (n > optimal + extra_steps) {
+            while (plan[i] >= branching)
+                ++i;
+
+            // Spread node i over the following nodes.
+            size_t remaining = plan[i];
+            do {
+                size_t fill = std::min(remaining + plan[i + 1], branching);
+                plan[i] = fill;
+                remaining = remaining + plan[i + 1] - fill;
+                ++i;
+            } while (remaining > 0);
+
+            for (size_t j = i; j + 1 < n; ++j)
+                plan[j] = plan[j + 1];
+            --n;
+            --i;
+        }
+        return n;
+    }
+
+    // Moves the slots of all into nodes of the planned sizes, reusing nodes
+    // whose size already matches.
+    static void execute_plan(node_list& all, const size_t* plan, size_t planned, node_list& merged) {
+        unsigned shift = all.shift;
+        size_t idx = 0, offset = 0;
+        for (size_t k = 0; k < planned; ++k) {
+            if (offset == 0 && all.items[idx]->count == plan[k]) {
+                merged.push(std::exchange(all.items[idx++], nullptr));
+                continue;
+            }
+
+            owned holder{shift == 0 ? static_cast<node*>(new_leaf()) : new_inner(), shift};
+            node* fresh = holder.n;
+            while (fresh->count < plan[k]) {
+                node* src = all.items[idx];
+                size_t take = std::min<size_t>(plan[k] - fresh->count, src->count - offset);
+                if (shift == 0) {
+                    leaf* to = static_cast<leaf*>(fresh);
+                    const leaf* from = static_cast<const leaf*>(src);
+                    for (size_t j = 0; j < take; ++j, ++to->count)
+                        std::construct_at(to->values() + to->count, from->values()[offset + j]);
+                } else {
+                    inner* to = static_cast<inner*>(fresh);
+                    const inner* from = static_cast<const inner*>(src);
+                    for (size_t j = 0; j < take; ++j)
+                        to->children[to->count++] = retain(from->children[offset + j]);
+                }
+
+                offset += take;
+                if (offset == src->count) {
+                    release(std::exchange(all.items[idx++], nullptr), shift);
+                    offset = 0;
+                }
+            }
+            if (shift > 0) set_sizes(static_cast<inner*>(fresh), shift);
+            merged.push(holder.take());
+        }
+    }
+
+    // A node at height shift over merged.items[first, last), which it takes.
+    static inner* take_children(node_list& merged, size_t first, size_t last, unsigned shift) {
+        inner* parent = new_inner();
+        for (size_t i = first; i < last; ++i)
+            parent->children[parent->count++] = std::exchange(merged.items[i], nullptr);
+        owned holder{parent, shift};
+        set_sizes(parent, shift);
+        return static_cast<inner*>(holder.take());
+    }
+
+    template <typename F>
+    static void walk(const node* n, unsigned shift, F& f) {
+        if (shift == 0) {
+            const leaf* l = static_cast<const leaf*>(n);
+            f(l->values(), size_t(l->count));
+            return;
+        }
+
+        const inner* in = static_cast<const inner*>(n);
+        for (uint32_t i = 0; i < in->count; ++i)
+            walk(in->children[i], shift - bits, f);
+    }
+};
+
+template <typename T>
+class transient_vector;
+
+// Immutable vector with structural sharing. push_back, set and concat leave
+// the vector unchanged and return a new version that shares all but
+// O(log32 n) nodes with it, so keeping many versions of a large vector
+// costs a few kilobytes per version rather than a full copy. Lookups walk
+// at most log32 n levels (4 levels cover a million elements); iteration
+// moves a leaf of 32 elements at a time.
+//
+// For building or bulk edits, transient() gives a mutable transient_vector
+// that writes in place to nodes no other version shares; persistent() turns
+// it back without copying. Versions can be read and copied from any number
+// of threads.
+template <typename T>
+class persistent_vector
+{
+    using tree = rrb_tree<T>;
+    using constReference = const T&;
+
+public:
+    class ConstIterator {
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = const T*;
+        using reference = const T&;
+
+    private:
+        const tree* tree_;
+        size_t index_;
+        // The leaf last looked up, covering [start_, end_).
+        mutable const T* values_ = nullptr;
+        mutable size_t start_ = 0;
+        mutable size_t end_ = 0;
+
+    public:
+        ConstIterator() : tree_(nullptr), index_(0) {}
+        ConstIterator(const tree* t, size_t index) : tree_(t), index_(index) {}
+
+        reference operator*() const {
+            if (index_ < start_ || index_ >= end_) values_ = tree_->leaf_for(index_, start_, end_);
+            return values_[index_ - start_];
+        }
+        pointer operator->() const { return &**this; }
+        reference operator[](difference_type n) const { return *(*this + n); }
+
+        ConstIterator& operator++() { ++index_; return *this; }
+        ConstIterator operator++(int) { ConstIterator temp = *this; ++index_; return temp; }
+        ConstIterator& operator--() { --index_; return *this; }
+        ConstIterator operator--(int) { ConstIterator temp = *this; --index_; return temp; }
+
+        ConstIterator& operator+=(difference_type n) { index_ += n; return *this; }
+        ConstIterator& operator-=(difference_type n) { index_ -= n; return *this; }
+
+        ConstIterator operator+(difference_type n) const { ConstIterator temp = *this; return temp += n; }
+        ConstIterator operator-(difference_type n) const { ConstIterator temp = *this; return temp -= n; }
+        difference_type operator-(const ConstIterator& other) const {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        friend ConstIterator operator+(difference_type n, const ConstIterator& it) { return it + n; }
+
+        bool operator==(const ConstIterator& other) const { return index_ == other.index_; }
+        bool operator!=(const ConstIterator& other) const { return index_ != other.index_; }
+        bool operator<(const ConstIterator& other) const { return index_ < other.index_; }
+        bool operator>(const ConstIterator& other) const { return index_ > other.index_; }
+        bool operator<=(const ConstIterator& other) const { return index_ <= other.index_; }
+        bool operator>=(const ConstIterator& other) const { return index_ >= other.index_; }
+    };
+
+    using Iterator = ConstIterator;
+
+private:
+    tree tree_;
+
+    friend class transient_vector<T>;
+
+    explicit persistent_vector(tree&& t) noexcept : tree_(std::move(t)) {}
+
+public:
+    persistent_vector() = default;
+
+    persistent_vector(std::initializer_list<T> init) : persistent_vector(std::span<const T>(init.begin(), init.size())) {}
+
+    explicit persistent_vector(std::span<const T> values) {
+        for (const T& value : values)
+            tree_.emplace_back(value);
+    }
+
+    template <typename InputIt>
+    persistent_vector(InputIt first, InputIt last) {
+        for (; first != last; ++first)
+            tree_.emplace_back(*first);
+    }
+
+    [[nodiscard]] persistent_vector push_back(const T& value) const {
+        tree t(tree_);
+        t.emplace_back(value);
+        return persistent_vector(std::move(t));
+    }
+
+    [[nodiscard]] persistent_vector push_back(T&& value) const {
+        tree t(tree_);
+        t.emplace_back(std::move(value));
+        return persistent_vector(std::move(t));
+    }
+
+    [[nodiscard]] persistent_vector set(size_t i, const T& value) const {
+        if (i >= size()) throw std::out_of_range("Index is out of range");
+
+        tree t(tree_);
+        t.get_mutable(i) = value;
+        return persistent_vector(std::move(t));
+    }
+
+    // The elements of this vector followed by those of other. Nodes of both
+    // are shared; only the ones along the seam are rebuilt.
+    [[nodiscard]] persistent_vector concat(const persistent_vector& other) const {
+        tree t(tree_);
+        t.append(other.tree_);
+        return persistent_vector(std::move(t));
+    }
+
+    [[nodiscard]] transient_vector<T> transient() const { return transient_vector<T>(tree_); }
+
+    constReference operator[](size_t i) const { return tree_.get(i); }
+
+    constReference at(size_t ind) const {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return tree_.get(ind);
+    }
+
+    constReference front() const { return tree_.get(0); }
+    constReference back() const { return tree_.get(size() - 1); }
+
+    size_t size() const noexcept { return tree_.size(); }
+    bool empty() const noexcept { return tree_.size() == 0; }
+
+    // Calls f(value) for every element in order, a leaf at a time.
+    template <typename F>
+    void for_each(F f) const {
+        auto visit = [&f](const T* values, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                f(values[i]);
+        };
+        tree_.for_each_leaf(visit);
+    }
+
+    ConstIterator begin() const noexcept { return ConstIterator(&tree_, 0); }
+    ConstIterator end() const noexcept { return ConstIterator(&tree_, size()); }
+
+    ConstIterator cbegin() const noexcept { return ConstIterator(&tree_, 0); }
+    ConstIterator cend() const noexcept { return ConstIterator(&tree_, size()); }
+
+    friend bool operator==(const persistent_vector& a, const persistent_vector& b) {
+        return std::equal(a.begin(), a.end(), b.begin(), b.end());
+    }
+};
+
+// Mutable view of a persistent_vector for batches of edits. Nodes it shares
+// with persistent versions are copied on first write; nodes it created are
+// then written in place, so n push_backs cost about as much as on a vector.
+// A transient_vector belongs to one thread at a time.
+template <typename T>
+class transient_vector
+{
+    using tree = rrb_tree<T>;
+    using reference = T&;
+    using constReference = const T&;
+
+    tree tree_;
+
+    friend class persistent_vector<T>;
+
+    explicit transient_vector(const tree& t) : tree_(t) {}
+
+public:
+    transient_vector() = default;
+
+    void push_back(const T& value) { tree_.emplace_back(value); }
+    void push_back(T&& value) { tree_.emplace_back(std::move(value)); }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        tree_.emplace_back(std::forward<Args>(args)...);
+    }
+
+    void set(size_t i, const T& value) {
+        if (i >= size()) throw std::out_of_range("Index is out of range");
+        tree_.get_mutable(i) = value;
+    }
+
+    void append(const persistent_vector<T>& other) { tree_.append(other.tree_); }
+
+    constReference operator[](size_t i) const { return tree_.get(i); }
+
+    constReference at(size_t ind) const {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return tree_.get(ind);
+    }
+
+    size_t size() const noexcept { return tree_.size(); }
+    bool empty() const noexcept { return tree_.size() == 0; }
+
+    // Hands the elements over to a persistent_vector, leaving this empty.
+    persistent_vector<T> persistent() { return persistent_vector<T>(std::move(tree_)); }
+};
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <new>
+#include <span>
+#include <stdexcept>
+
+#include "../vector/vector.h"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define EYTZINGER_PREFETCH(p) __builtin_prefetch(p)
+#else
+#define EYTZINGER_PREFETCH(p) ((void)0)
+#endif
+
+// Read-only search index over sorted keys, stored in Eytzinger (BFS) order:
+// node k has children 2k and 2k+1, so the top levels of every search share
+// a few hot cache lines, and the 16 descendants four levels below k (for
+// 4-byte keys) are one contiguous, cache-line-aligned block that can be
+// prefetched while the current level is compared. The descent is branchless.
+//
+// Results are ranks in the original sorted order, i.e. what std::lower_bound
+// over the input would return, so they can index the caller's own arrays.
+// The input must be sorted by Compare; at most 2^32 - 1 keys are supported.
+template <typename T, typename Compare = std::less<T>>
+class eytzinger_index
+{
+    template <typename U>
+    struct cache_line_allocator {
+        using value_type = U;
+
+        cache_line_allocator() = default;
+        template <typename V>
+        cache_line_allocator(const cache_line_allocator<V>&) noexcept {}
+
+        U* allocate(size_t n) {
+            return static_cast<U*>(::operator new(n * sizeof(U), std::align_val_t(cache_line)));
+        }
+
+        void deallocate(U* p, size_t) noexcept {
+            ::operator delete(p, std::align_val_t(cache_line));
+        }
+
+        friend bool operator==(const cache_line_allocator&, const cache_line_allocator&) { return true; }
+    };
+
+    using rank_type = uint32_t;
+
+    static constexpr size_t cache_line = 64;
+    static constexpr size_t prefetch_stride = sizeof(T) <= cache_line ? cache_line / sizeof(T) : 1;
+
+    // Slot 0 is unused padding so that node k sits at tree_[k].
+    vector<T, cache_line_allocator<T>> tree_;
+    vector<rank_type> rank_;
+    size_t size_ = 0;
+    Compare comp_;
+
+public:
+    static constexpr size_t batch_size = 16;
+
+    eytzinger_index() = default;
+
+    explicit eytzinger_index(std::span<const T> sorted, const Compare& comp = Compare())
+        : size_(sorted.size()), comp_(comp) {
+        if (sorted.size() >= std::numeric_limits<rank_type>::max())
+            throw std::length_error("eytzinger_index: too many keys");
+        if (size_ == 0) return;
+
+        rank_.resize(size_ + 1);
+        rank_type next = 0;
+        assign_ranks(1, next);
+
+        tree_.reserve(size_ + 1);
+        tree_.push_back(sorted[0]);
+        for (size_t k = 1; k <= size_; ++k)
+            tree_.push_back(sorted[rank_[k]]);
+    }
+
+    explicit eytzinger_index(const vector<T>& sorted, const Compare& comp = Compare())
+        : eytzinger_index(std::span<const T>(sorted.data(), sorted.size()), comp) {}
+
+    // Rank of the first key not less than key, or size() if there is none.
+    size_t lower_bound(const T& key) const {
+        return descend<false>(key);
+    }
+
+    // Rank of the first key greater than key, or size() if there is none.
+    size_t upper_bound(const T& key) const {
+        return descend<true>(key);
+    }
+
+    bool contains(const T& key) const {
+        size_t k = leaf<false>(key);
+        return k != 0 && !comp_(key, tree_[k]);
+    }
+
+    // Batched lower_bound: out[i] = lower_bound(keys[i]). Runs batch_size
+    // descents in lockstep so their cache misses overlap instead of queueing
+    // one behind another.
+    void lower_bound(std::span<const T> keys, std::span<size_t> out) const {
+        if (out.size() < keys.size()) throw std::invalid_argument("eytzinger_index: output span too small");
+
+        for (size_t base = 0; base < keys.size(); base += batch_size) {
+            size_t m = std::min(batch_size, keys.size() - base);
+            const T* batch = keys.data() + base;
+            size_t k[batch_size];
+            for (size_t j = 0; j < m; ++j)
+                k[j] = 1;
+
+            for (size_t level = 0; level < full_levels(); ++level) {
+                for (size_t j = 0; j < m; ++j) {
+                    prefetch(k[j]);
+                    k[j] = 2 * k[j] + comp_(tree_[k[j]], batch[j]);
+                }
+            }
+
+            for (size_t j = 0; j < m; ++j) {
+                if (k[j] <= size_) k[j] = 2 * k[j] + comp_(tree_[k[j]], batch[j]);
+                out[base + j] = to_rank(k[j]);
+            }
+        }
+    }
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    // Bytes held by the index: the relaid keys plus the rank table.
+    size_t memory_bytes() const noexcept {
+        return tree_.capacity() * sizeof(T) + rank_.capacity() * sizeof(rank_type);
+    }
+
+private:
+    // In-order walk of the implicit tree: the i-th node visited holds the
+    // i-th smallest key.
+    void assign_ranks(size_t k, rank_type& next) {
+        if (k > size_) return;
+
+        assign_ranks(2 * k, next);
+        rank_[k] = next++;
+        assign_ranks(2 * k + 1, next);
+    }
+
+    // Levels where every path is still inside the tree.
+    size_t full_levels() const noexcept {
+        return std::bit_width(size_ + 1) - 1;
+    }
+
+    void prefetch(size_t k) const noexcept {
+        if constexpr (prefetch_stride > 1) EYTZINGER_PREFETCH(tree_.data() + k * prefetch_stride);
+    }
+
+    // Descends to a position past the leaves. Going right at node k means
+    // tree_[k] is before the answer, so the answer is the last node where the
+    // walk went left.
+    template <bool Upper>
+    size_t leaf(const T& key) const {
+        size_t k = 1;
+        while (k <= size_) {
+            prefetch(k);
+            if constexpr (Upper)
+                k = 2 * k + !comp_(key, tree_[k]);
+            else
+                k = 2 * k + comp_(tree_[k], key);
+        }
+        return k >> (std::countr_one(k) + 1);
+    }
+
+    template <bool Upper>
+    size_t descend(const T& key) const {
+        size_t k = leaf<Upper>(key);
+        return k == 0 ? size_ : rank_[k];
+    }
+
+    size_t to_rank(size_t k) const noexcept {
+        k >>= std::countr_one(k) + 1;
+        return k == 0 ? size_ : rank_[k];
+    }
+};
+
+#undef EYTZINGER_PREFETCH
@@ -0,0 +1,373 @@
+#pragma once
+
+#include <algorithm>
+#include <memory>
+#include <cstddef>
+#include <cstring>
+#include <utility>
+#include <stdexcept>
+#include <new>
+#include <type_traits>
+
+#include "../vector/vector.h"
+
+// vector with room for N elements inside the object itself. The allocator is
+// only used once the size grows past N; shrink_to_fit moves back inline.
+template <typename T, size_t N, typename Alloc = std::allocator<T>>
+class small_vector
+{
+    static_assert(N > 0, "small_vector requires an inline capacity of at least one element");
+
+    using traits = std::allocator_traits<Alloc>;
+    using pointer = T*;
+    using reference = T&;
+    using constReference = const T&;
+
+public:
+    using Iterator = typename vector<T, Alloc>::Iterator;
+    using ConstIterator = typename vector<T, Alloc>::ConstIterator;
+
+private:
+    pointer begin_;
+    pointer end_;
+    pointer capacity_;
+    Alloc alloc_;
+    alignas(T) unsigned char inline_[N * sizeof(T)];
+
+public:
+    small_vector() noexcept : begin_(inline_data()), end_(begin_), capacity_(begin_ + N) {}
+
+    explicit small_vector(const Alloc& alloc) noexcept
+        : begin_(inline_data()), end_(begin_), capacity_(begin_ + N), alloc_(alloc) {}
+
+    small_vector(size_t n, const T& value, const Alloc& alloc = Alloc()) : small_vector(alloc) {
+        reserve(n);
+        for (size_t i = 0; i < n; ++i, ++end_)
+            std::construct_at(end_, value);
+    }
+
+    small_vector(const small_vector& other)
+        : small_vector(traits::select_on_container_copy_construction(other.alloc_)) {
+        reserve(other.size());
+        for (size_t i = 0; i < other.size(); ++i, ++end_)
+            std::construct_at(end_, other[i]);
+    }
+
+    // The allocator follows propagate_on_container_copy_assignment; heap
+    // storage from the old allocator is released before it is replaced.
+    small_vector& operator=(const small_vector& other) {
+        if (this == &other) return *this;
+
+        if constexpr (traits::propagate_on_container_copy_assignment::value) {
+            if (!same_allocator(other)) {
+                destroy_all();
+                deallocate();
+            }
+            alloc_ = other.alloc_;
+        }
+
+        clear();
+        reserve(other.size());
+        for (size_t i = 0; i < other.size(); ++i, ++end_)
+            std::construct_at(end_, other[i]);
+
+        return *this;
+    }
+
+    small_vector(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        : small_vector(std::move(other.alloc_)) {
+        steal(other);
+    }
+
+    // Heap storage from an allocator that neither propagates nor compares
+    // equal cannot be taken over; its elements are moved one by one instead.
+    small_vector& operator=(small_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T> &&
+                                                           (traits::propagate_on_container_move_assignment::value ||
+                                                            traits::is_always_equal::value)) {
+        if (this == &other) return *this;
+
+        destroy_all();
+        if constexpr (!traits::propagate_on_container_move_assignment::value) {
+            if (!other.is_inline() && !same_allocator(other)) {
+                reserve(other.size());
+                for (pointer p = other.begin_; p != other.end_; ++p, ++end_)
+                    std::construct_at(end_, std::move(*p));
+                other.destroy_all();
+                return *this;
+            }
+        }
+
+        deallocate();
+        if constexpr (traits::propagate_on_container_move_assignment::value)
+            alloc_ = std::move(other.alloc_);
+        steal(other);
+        return *this;
+    }
+
+    ~small_vector() {
+        destroy_all();
+        deallocate();
+    }
+
+    void swap(small_vector& other) {
+        if (this == &other) return;
+
+        small_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    void reserve(size_t n) {
+        if (n <= capacity()) return;
+        relocate(traits::allocate(alloc_, n), n);
+    }
+
+    void shrink_to_fit() {
+        if (is_inline() || size() == capacity()) return;
+
+        if (size() <= N)
+            relocate(inline_data(), N);
+        else
+            relocate(traits::allocate(alloc_, size()), size());
+    }
+
+    void assign(size_t n, const T& value) {
+        clear();
+        reserve(n);
+
+        for (size_t i = 0; i < n; ++i)
+            std::construct_at(begin_ + i, value);
+
+        end_ = begin_ + n;
+    }
+
+    void resize(size_t n) {
+        if (n <= size()) {
+            destroy_tail(n);
+            return;
+        }
+
+        grow_to(n);
+        for (pointer last = begin_ + n; end_ != last; ++end_)
+            std::construct_at(end_);
+    }
+
+    void resize(size_t n, const T& value) {
+        if (n <= size()) {
+            destroy_tail(n);
+            return;
+        }
+
+        grow_to(n);
+        for (pointer last = begin_ + n; end_ != last; ++end_)
+            std::construct_at(end_, value);
+    }
+
+    // Like resize(n), but new elements are default-initialized: trivially
+    // constructible types are left uninitialized instead of being zeroed.
+    void resize_default_init(size_t n) {
+        if (n <= size()) {
+            destroy_tail(n);
+            return;
+        }
+
+        grow_to(n);
+        if constexpr (std::is_trivially_default_constructible_v<T>) {
+            end_ = begin_ + n;
+        } else {
+            for (pointer last = begin_ + n; end_ != last; ++end_)
+                ::new (static_cast<void*>(end_)) T;
+        }
+    }
+
+    // Grows to n default-initialized elements, then calls op(data(), n) to fill
+    // the buffer in place. op returns the number of elements to keep, which
+    // must not exceed n.
+    template <typename Op>
+    void resize_and_overwrite(size_t n, Op op) {
+        if (n > size()) resize_default_init(n);
+        size_t kept = static_cast<size_t>(op(begin_, n));
+        destroy_tail(kept);
+    }
+
+    void push_back(const T& value) {
+        if (full()) grow();
+        std::construct_at(end_, value);
+        ++end_;
+    }
+
+    void push_back(T&& value) {
+        if (full()) grow();
+        std::construct_at(end_, std::move(value));
+        ++end_;
+    }
+
+    template <typename... Args>
+    void emplace_back(Args&&... args) {
+        if (full()) grow();
+        std::construct_at(end_, std::forward<Args>(args)...);
+        ++end_;
+    }
+
+    void pop_back() noexcept {
+        if (end_ == begin_) return;
+
+        --end_;
+        std::destroy_at(end_);
+    }
+
+    void clear() noexcept {
+        while (end_ != begin_) {
+            --end_;
+            std::destroy_at(end_);
+        }
+    }
+
+    reference operator[](size_t i) { return begin_[i]; }
+    constReference operator[](size_t i) const { return begin_[i]; }
+
+    reference at(size_t ind) {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return begin_[ind];
+    }
+
+    constReference at(size_t ind) const {
+        if (ind >= size()) throw std::out_of_range("Index is out of range");
+        return begin_[ind];
+    }
+
+    pointer data() { return begin_; }
+    const T* data() const { return begin_; }
+
+    size_t size() const noexcept { return end_ - begin_; }
+    size_t capacity() const noexcept { return capacity_ - begin_; }
+    bool is_inline() const noexcept { return begin_ == inline_data(); }
+    static constexpr size_t inline_capacity() noexcept { return N; }
+
+    Iterator begin() noexcept { return Iterator(begin_); }
+    Iterator end() noexcept { return Iterator(end_); }
+
+    ConstIterator begin() const noexcept { return ConstIterator(begin_); }
+    ConstIterator end() const noexcept { return ConstIterator(end_); }
+
+    ConstIterator cbegin() const noexcept { return ConstIterator(begin_); }
+    ConstIterator cend() const noexcept { return ConstIterator(end_); }
+
+    // value is copied before anything moves, since it may refer into this
+    // vector.
+    Iterator insert(ConstIterator pos, constReference value) {
+        size_t index = pos - cbegin();
+        T copy(value);
+        if (full()) grow();
+
+        for (size_t i = size(); i > index; --i) {
+            std::construct_at(begin_ + i, std::move(begin_[i - 1]));
+            std::destroy_at(begin_ + i - 1);
+        }
+
+        std::construct_at(begin_ + index, std::move(copy));
+        ++end_;
+        return Iterator(begin_ + index);
+    }
+
+    Iterator erase(ConstIterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+    Iterator erase(ConstIterator first, ConstIterator last) {
+        size_t start = first - cbegin();
+        size_t count = last - first;
+        if (count == 0) return Iterator(begin_ + start);
+
+        move_down(begin_ + start + count, end_, begin_ + start);
+        destroy_tail(size() - count);
+        return Iterator(begin_ + start);
+    }
+
+private:
+    pointer inline_data() noexcept { return reinterpret_cast<pointer>(inline_); }
+    const T* inline_data() const noexcept { return reinterpret_cast<const T*>(inline_); }
+
+    bool full() const { return end_ == capacity_; }
+
+    void grow() { reserve(2 * capacity()); }
+
+    void grow_to(size_t n) {
+        if (n > capacity()) reserve(n > 2 * capacity() ? n : 2 * capacity());
+    }
+
+    bool same_allocator(const small_vector& other) const noexcept {
+        if constexpr (traits::is_always_equal::value)
+            return true;
+        else
+            return alloc_ == other.alloc_;
+    }
+
+    // Moves [first, last) down onto dest, which is at or before first.
+    void move_down(pointer first, pointer last, pointer dest) {
+        if (first == dest || first == last) return;
+
+        if constexpr (std::is_trivially_copyable_v<T>)
+            std::memmove(dest, first, (last - first) * sizeof(T));
+        else
+            std::move(first, last, dest);
+    }
+
+    void destroy_tail(size_t n) noexcept {
+        pointer new_end = begin_ + n;
+        while (end_ > new_end) {
+            --end_;
+            std::destroy_at(end_);
+        }
+    }
+
+    void destroy_all() noexcept {
+        for (pointer p = begin_; p != end_; ++p)
+            std::destroy_at(p);
+        end_ = begin_;
+    }
+
+    void deallocate() noexcept {
+        if (!is_inline()) {
+            traits::deallocate(alloc_, begin_, capacity());
+            begin_ = end_ = inline_data();
+            capacity_ = begin_ + N;
+        }
+    }
+
+    // Moves the elements into new_begin, which is either a fresh heap block or
+    // the inline buffer, and releases the old heap block if there was one.
+    void relocate(pointer new_begin, size_t new_capacity) {
+        pointer new_end = new_begin;
+
+        for (pointer p = begin_; p != end_; ++p, ++new_end) {
+            std::construct_at(new_end, std::move(*p));
+            std::destroy_at(p);
+        }
+
+        if (!is_inline())
+            traits::deallocate(alloc_, begin_, capacity());
+
+        begin_ = new_begin;
+        end_ = new_end;
+        capacity_ = new_begin + new_capacity;
+    }
+
+    // Heap storage is handed over by pointer; inline elements have to be moved
+    // one by one, since they live inside other.
+    void steal(small_vector& other) {
+        if (other.is_inline()) {
+            for (pointer p = other.begin_; p != other.end_; ++p, ++end_)
+                std::construct_at(end_, std::move(*p));
+            other.destroy_all();
+            return;
+        }
+
+        begin_ = other.begin_;
+        end_ = other.end_;
+        capacity_ = other.capacity_;
+
+        other.begin_ = other.end_ = other.inline_data();
+        other.capacity_ = other.begin_ + N;
+    }
+};
@@ -0,0 +1,481 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+// Proxy reference to one row of a soa_vector: a tuple of references to the
+// row's fields, one per column. Assigning to a soa_row writes through to the
+// row, even through a const soa_row, and swap exchanges the rows' contents,
+// which is what lets the iterators model std::sortable so that
+// std::ranges::sort, remove_if, reverse and friends work on the container.
+// soa_row<const Ts...> is the read-only row. libstdc++ 12 implements
+// ranges::stable_sort, stable_partition and inplace_merge with the legacy
+// algorithms, which need a random access iterator_category, so those three
+// do not compile there.
+template <typename... Ts>
+class soa_row : public std::tuple<Ts&...>
+{
+    using base = std::tuple<Ts&...>;
+
+    static constexpr bool writable = (!std::is_const_v<Ts> && ...);
+
+public:
+    using value_type = std::tuple<std::remove_const_t<Ts>...>;
+
+    using base::base;
+
+    template <typename... Us>
+        requires (sizeof...(Us) == sizeof...(Ts) && (std::is_convertible_v<Us&, Ts&> && ...))
+    soa_row(std::tuple<Us...>& row) : base(std::apply([](Us&... fields) { return base(fields...); }, row)) {}
+
+    soa_row(const soa_row&) = default;
+
+    const soa_row& operator=(const soa_row& other) const requires writable {
+        assign(static_cast<const base&>(other));
+        return *this;
+    }
+
+    const soa_row& operator=(const value_type& row) const requires writable {
+        assign(row);
+        return *this;
+    }
+
+    const soa_row& operator=(value_type&& row) const requires writable {
+        assign(std::move(row));
+        return *this;
+    }
+
+    operator value_type() const { return value_type(static_cast<const base&>(*this)); }
+
+    friend void swap(const soa_row& a, const soa_row& b) requires writable {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            using std::swap;
+            (swap(std::get<I>(static_cast<const base&>(a)), std::get<I>(static_cast<const base&>(b))), ...);
+        }(std::index_sequence_for<Ts...>());
+    }
+
+private:
+    template <typename Row>
+    void assign(Row&& row) const {
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            ((std::get<I>(static_cast<const base&>(*this)) = std::get<I>(std::forward<Row>(row))), ...);
+        }(std::index_sequence_for<Ts...>());
+    }
+};
+
+template <typename... Ts>
+struct std::tuple_size<soa_row<Ts...>> : std::integral_constant<size_t, sizeof...(Ts)> {};
+
+template <size_t I, typename... Ts>
+struct std::tuple_element<I, soa_row<Ts...>> {
+    using type = std::tuple_element_t<I, std::tuple<Ts&...>>;
+};
+
+// Common references between a soa_row and a tuple of values, which the
+// iterator concepts require: a soa_row when every field's common reference
+// is an lvalue reference, and a tuple of the fields' common references
+// otherwise.
+template <typename... Rs>
+using soa_common_row = std::conditional_t<(std::is_lvalue_reference_v<Rs> && ...),
+                                          soa_row<std::remove_reference_t<Rs>...>, std::tuple<Rs...>>;
+
+template <typename... Ts, typename... Us, template <typename> class TQual, template <typename> class UQual>
+    requires (sizeof...(Ts) == sizeof...(Us))
+struct std::basic_common_reference<soa_row<Ts...>, std::tuple<Us...>, TQual, UQual> {
+    using type = soa_common_row<std::common_reference_t<TQual<Ts&>, UQual<Us>>...>;
+};
+
+template <typename... Us, typename... Ts, template <typename> class TQual, template <typename> class UQual>
+    requires (sizeof...(Ts) == sizeof...(Us))
+struct std::basic_common_reference<std::tuple<Us...>, soa_row<Ts...>, TQual, UQual> {
+    using type = soa_common_row<std::common_reference_t<TQual<Us>, UQual<Ts&>>...>;
+};
+
+// Struct-of-arrays vector: soa_vector<int, float, Id> keeps each field in its
+// own contiguous column, so a loop over two fields streams two arrays instead
+// of dragging whole records through the cache. All columns share a single
+// allocation and each starts on a 64-byte boundary. Element access yields a
+// soa_row of references (structured bindings and std::get work); column<I>()
+// exposes one field as a span for vectorized kernels.
+template <typename... Ts>
+class soa_vector
+{
+    static_assert(sizeof...(Ts) > 0, "soa_vector needs at least one column");
+    static_assert(((alignof(Ts) <= 64) && ...), "soa_vector column alignment must not exceed 64");
+
+    static constexpr size_t columns = sizeof...(Ts);
+    static constexpr size_t column_alignment = 64;
+
+    using column_pointers = std::tuple<Ts*...>;
+
+public:
+    using value_type = std::tuple<Ts...>;
+    using reference = soa_row<Ts...>;
+    using constReference = soa_row<const Ts...>;
+
+    template <size_t I>
+    using column_type = std::tuple_element_t<I, value_type>;
+
+private:
+    // Iterators hold (owner, index) and dereference to a soa_row proxy, so
+    // they model random access and sortable for C++20 ranges but only input
+    // for legacy algorithms that expect a real reference. iter_move moves a
+    // row out into a value_type.
+    template <bool Const>
+    class basic_iterator {
+        using owner = std::conditional_t<Const, const soa_vector, soa_vector>;
+
+    public:
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = soa_vector::value_type;
+        using reference = std::conditional_t<Const, soa_vector::constReference, soa_vector::reference>;
+
+    private:
+        owner* vec_;
+        size_t index_;
+
+        friend class soa_vector;
+        friend class basic_iterator<!Const>;
+
+    public:
+        basic_iterator() : vec_(nullptr), index_(0) {}
+        basic_iterator(owner* vec, size_t index) : vec_(vec), index_(index) {}
+
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& it) : vec_(it.vec_), index_(it.index_) {}
+
+        reference operator*() const { return (*vec_)[index_]; }
+        reference operator[](difference_type n) const { return (*vec_)[index_ + n]; }
+
+        friend value_type iter_move(const basic_iterator& it) requires (!Const) {
+            return std::apply([i = it.index_](Ts*... cols) { return value_type(std::move(cols[i])...); },
+                              it.vec_->columns_);
+        }
+
+        basic_iterator& operator++() { ++index_; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp = *this; ++index_; return temp; }
+        basic_iterator& operator--() { --index_; return *this; }
+        basic_iterator operator--(int) { basic_iterator temp = *this; --index_; return temp; }
+
+        basic_iterator& operator+=(difference_type n) { index_ += n; return *this; }
+        basic_iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+
+        basic_iterator operator+(difference_type n) const { return basic_iterator(vec_, index_ + n); }
+        basic_iterator operator-(difference_type n) const { return basic_iterator(vec_, index_ - n); }
+        difference_type operator-(const basic_iterator& other) const {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        friend basic_iterator operator+(difference_type n, const basic_iterator& it) { return it + n; }
+
+        bool operator==(const basic_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const basic_iterator& other) const { return index_ != other.index_; }
+        bool operator<(const basic_iterator& other) const { return index_ < other.index_; }
+        bool operator>(const basic_iterator& other) const { return index_ > other.index_; }
+        bool operator<=(const basic_iterator& other) const { return index_ <= other.index_; }
+        bool operator>=(const basic_iterator& other) const { return index_ >= other.index_; }
+    };
+
+public:
+    using Iterator = basic_iterator<false>;
+    using ConstIterator = basic_iterator<true>;
+
+private:
+    unsigned char* buffer_ = nullptr;
+    column_pointers columns_{};
+    size_t size_ = 0;
+    size_t capacity_ = 0;
+
+public:
+    soa_vector() = default;
+
+    soa_vector(const soa_vector& other) {
+        if (other.size_ == 0) return;
+
+        unsigned char* buffer = allocate(other.size_);
+        column_pointers cols = column_starts(buffer, other.size_);
+        try {
+            transfer<false>(other.columns_, cols, other.size_);
+        } catch (...) {
+            deallocate(buffer);
+            throw;
+        }
+        buffer_ = buffer;
+        columns_ = cols;
+        size_ = capacity_ = other.size_;
+    }
+
+    soa_vector(soa_vector&& other) noexcept
+        : buffer_(other.buffer_), columns_(other.columns_), size_(other.size_), capacity_(other.capacity_) {
+        other.buffer_ = nullptr;
+        other.columns_ = column_pointers{};
+        other.size_ = 0;
+        other.capacity_ = 0;
+    }
+
+    soa_vector& operator=(const soa_vector& other) {
+        if (this != &other) {
+            soa_vector tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    soa_vector& operator=(soa_vector&& other) noexcept {
+        if (this != &other) {
+            soa_vector tmp(std::move(other));
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    ~soa_vector() {
+        clear();
+        deallocate(buffer_);
+    }
+
+    void swap(soa_vector& other) noexcept {
+        std::swap(buffer_, other.buffer_);
+        std::swap(columns_, other.columns_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    void reserve(size_t n) {
+        if (n > capacity_) reallocate(n);
+    }
+
+    void shrink_to_fit() {
+        if (size_ == capacity_) return;
+
+        if (size_ == 0) {
+            deallocate(buffer_);
+            buffer_ = nullptr;
+            columns_ = column_pointers{};
+            capacity_ = 0;
+            return;
+        }
+        reallocate(size_);
+    }
+
+    // Takes one argument per column.
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        static_assert(sizeof...(Args) == columns, "emplace_back takes one argument per column");
+
+        if (size_ == capacity_) {
+            // args may refer into this vector, so the row is built before the
+            // columns move.
+            value_type row(std::forward<Args>(args)...);
+            reallocate(capacity_ == 0 ? 1 : 2 * capacity_);
+            construct_row(size_, std::move(row));
+        } else {
+            construct_row(size_, std::forward_as_tuple(std::forward<Args>(args)...));
+        }
+        return (*this)[size_++];
+    }
+
+    void push_back(const Ts&... values) {
+        emplace_back(values...);
+    }
+
+    void push_back(const value_type& row) {
+        std::apply([this](const Ts&... values) { emplace_back(values...); }, row);
+    }
+
+    void push_back(value_type&& row) {
+        std::apply([this](Ts&... values) { emplace_back(std::move(values)...); }, row);
+    }
+
+    void pop_back() noexcept {
+        if (size_ == 0) return;
+
+        --size_;
+        destroy_row(size_);
+    }
+
+    void clear() noexcept {
+        while (size_ > 0) {
+            --size_;
+            destroy_row(size_);
+        }
+    }
+
+    // New rows are value-initialized.
+    void resize(size_t n) {
+        if (n <= size_) {
+            while (size_ > n) {
+                --size_;
+                destroy_row(size_);
+            }
+            return;
+        }
+
+        reserve(n);
+        for (; size_ < n; ++size_)
+            construct_row(size_, std::tuple<>());
+    }
+
+    reference operator[](size_t i) {
+        return std::apply([i](Ts*... cols) { return reference(cols[i]...); }, columns_);
+    }
+
+    constReference operator[](size_t i) const {
+        return std::apply([i](const Ts*... cols) { return constReference(cols[i]...); }, columns_);
+    }
+
+    reference at(size_t ind) {
+        if (ind >= size_) throw std::out_of_range("Index is out of range");
+        return (*this)[ind];
+    }
+
+    constReference at(size_t ind) const {
+        if (ind >= size_) throw std::out_of_range("Index is out of range");
+        return (*this)[ind];
+    }
+
+    reference front() { return (*this)[0]; }
+    constReference front() const { return (*this)[0]; }
+    reference back() { return (*this)[size_ - 1]; }
+    constReference back() const { return (*this)[size_ - 1]; }
+
+    template <size_t I>
+    column_type<I>* data() noexcept { return std::get<I>(columns_); }
+
+    template <size_t I>
+    const column_type<I>* data() const noexcept { return std::get<I>(columns_); }
+
+    template <size_t I>
+    std::span<column_type<I>> column() noexcept { return {std::get<I>(columns_), size_}; }
+
+    template <size_t I>
+    std::span<const column_type<I>> column() const noexcept { return {std::get<I>(columns_), size_}; }
+
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return capacity_; }
+    bool empty() const noexcept { return size_ == 0; }
+
+    static constexpr size_t max_size() noexcept {
+        return (static_cast<size_t>(PTRDIFF_MAX) - columns * column_alignment) / (sizeof(Ts) + ...);
+    }
+
+    Iterator begin() noexcept { return Iterator(this, 0); }
+    Iterator end() noexcept { return Iterator(this, size_); }
+
+    ConstIterator begin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator end() const noexcept { return ConstIterator(this, size_); }
+
+    ConstIterator cbegin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator cend() const noexcept { return ConstIterator(this, size_); }
+
+private:
+    static constexpr size_t round_up(size_t n) noexcept {
+        return (n + column_alignment - 1) & ~(column_alignment - 1);
+    }
+
+    // offsets[i] is where column i starts; offsets[columns] is the total size.
+    static std::array<size_t, columns + 1> layout(size_t capacity) noexcept {
+        constexpr size_t sizes[] = {sizeof(Ts)...};
+        std::array<size_t, columns + 1> offsets{};
+        for (size_t i = 0; i < columns; ++i)
+            offsets[i + 1] = offsets[i] + round_up(sizes[i] * capacity);
+        return offsets;
+    }
+
+    static column_pointers column_starts(unsigned char* buffer, size_t capacity) noexcept {
+        auto offsets = layout(capacity);
+        return [&]<size_t... I>(std::index_sequence<I...>) {
+            return column_pointers(reinterpret_cast<Ts*>(buffer + offsets[I])...);
+        }(std::index_sequence_for<Ts...>());
+    }
+
+    static unsigned char* allocate(size_t capacity) {
+        if (capacity > max_size()) throw std::length_error("soa_vector: capacity too large");
+        return static_cast<unsigned char*>(::operator new(layout(capacity)[columns], std::align_val_t(column_alignment)));
+    }
+
+    static void deallocate(unsigned char* buffer) noexcept {
+        if (buffer) ::operator delete(buffer, std::align_val_t(column_alignment));
+    }
+
+    void reallocate(size_t newCapacity) {
+        unsigned char* buffer = allocate(newCapacity);
+        column_pointers cols = column_starts(buffer, newCapacity);
+        try {
+            transfer<true>(columns_, cols, size_);
+        } catch (...) {
+            deallocate(buffer);
+            throw;
+        }
+
+        for (size_t i = 0; i < size_; ++i)
+            destroy_row(i);
+        deallocate(buffer_);
+
+        buffer_ = buffer;
+        columns_ = cols;
+        capacity_ = newCapacity;
+    }
+
+    // Copies (or, with Move, moves where that cannot throw) the first n rows
+    // into uninitialized columns. A throwing column unwinds the ones before it.
+    template <bool Move, size_t I = 0>
+    static void transfer(const column_pointers& from, const column_pointers& to, size_t n) {
+        if constexpr (I < columns) {
+            using U = column_type<I>;
+            U* src = std::get<I>(from);
+            U* dst = std::get<I>(to);
+
+            if constexpr (std::is_trivially_copyable_v<U>) {
+                if (n > 0) std::memcpy(dst, src, n * sizeof(U));
+            } else if constexpr (Move && std::is_nothrow_move_constructible_v<U>) {
+                std::uninitialized_move_n(src, n, dst);
+            } else {
+                std::uninitialized_copy_n(src, n, dst);
+            }
+
+            try {
+                transfer<Move, I + 1>(from, to, n);
+            } catch (...) {
+                std::destroy_n(dst, n);
+                throw;
+            }
+        }
+    }
+
+    // Constructs row i column by column from args, or value-initializes it
+    // when args is empty; on a throw the columns already built are destroyed.
+    template <size_t I = 0, typename Args>
+    void construct_row(size_t i, Args&& args) {
+        if constexpr (I < columns) {
+            column_type<I>* slot = std::get<I>(columns_) + i;
+            if constexpr (std::tuple_size_v<std::remove_reference_t<Args>> == 0)
+                std::construct_at(slot);
+            else
+                std::construct_at(slot, std::get<I>(std::forward<Args>(args)));
+
+            try {
+                construct_row<I + 1>(i, std::forward<Args>(args));
+            } catch (...) {
+                std::destroy_at(slot);
+                throw;
+            }
+        }
+    }
+
+    void destroy_row(size_t i) noexcept {
+        std::apply([i](Ts*... cols) { (std::destroy_at(cols + i), ...); }, columns_);
+    }
+};
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Segmented vector whose elements never move. Storage is a sequence of
+// blocks of B, 2B, 4B, ... elements; growing appends the next block, so
+// pointers and references stay valid across push_back and there is no
+// copy-everything step. Element i lives in block bit_width(i + B) - 1 - log2(B)
+// at offset (i + B) minus that block's first index, which makes operator[]
+// a handful of bit operations.
+template <typename T, typename Alloc = std::allocator<T>>
+class stable_vector
+{
+    using traits = std::allocator_traits<Alloc>;
+    using pointer = T*;
+    using reference = T&;
+    using constReference = const T&;
+
+    static constexpr size_t first_block_shift = 4;
+    static constexpr size_t first_block = size_t(1) << first_block_shift;
+    static constexpr size_t max_blocks = sizeof(size_t) * 8 - first_block_shift;
+
+    template <bool Const>
+    class basic_iterator {
+        using owner = std::conditional_t<Const, const stable_vector, stable_vector>;
+
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using difference_type = std::ptrdiff_t;
+        using value_type = T;
+        using pointer = std::conditional_t<Const, const T*, T*>;
+        using reference = std::conditional_t<Const, const T&, T&>;
+
+    private:
+        owner* vec_;
+        size_t index_;
+
+        friend class stable_vector;
+        friend class basic_iterator<!Const>;
+
+    public:
+        basic_iterator() : vec_(nullptr), index_(0) {}
+        basic_iterator(owner* vec, size_t index) : vec_(vec), index_(index) {}
+
+        template <bool C = Const, typename = std::enable_if_t<C>>
+        basic_iterator(const basic_iterator<false>& it) : vec_(it.vec_), index_(it.index_) {}
+
+        reference operator*() const { return (*vec_)[index_]; }
+        pointer operator->() const { return &(*vec_)[index_]; }
+        reference operator[](difference_type n) const { return (*vec_)[index_ + n]; }
+
+        basic_iterator& operator++() { ++index_; return *this; }
+        basic_iterator operator++(int) { basic_iterator temp = *this; ++index_; return temp; }
+        basic_iterator& operator--() { --index_; return *this; }
+        basic_iterator operator--(int) { basic_iterator temp = *this; --index_; return temp; }
+
+        basic_iterator& operator+=(difference_type n) { index_ += n; return *this; }
+        basic_iterator& operator-=(difference_type n) { index_ -= n; return *this; }
+
+        basic_iterator operator+(difference_type n) const { return basic_iterator(vec_, index_ + n); }
+        basic_iterator operator-(difference_type n) const { return basic_iterator(vec_, index_ - n); }
+        difference_type operator-(const basic_iterator& other) const {
+            return static_cast<difference_type>(index_) - static_cast<difference_type>(other.index_);
+        }
+
+        friend basic_iterator operator+(difference_type n, const basic_iterator& it) { return it + n; }
+
+        bool operator==(const basic_iterator& other) const { return index_ == other.index_; }
+        bool operator!=(const basic_iterator& other) const { return index_ != other.index_; }
+        bool operator<(const basic_iterator& other) const { return index_ < other.index_; }
+        bool operator>(const basic_iterator& other) const { return index_ > other.index_; }
+        bool operator<=(const basic_iterator& other) const { return index_ <= other.index_; }
+        bool operator>=(const basic_iterator& other) const { return index_ >= other.index_; }
+    };
+
+public:
+    using Iterator = basic_iterator<false>;
+    using ConstIterator = basic_iterator<true>;
+
+private:
+    pointer blocks_[max_blocks] = {};
+    size_t block_count_ = 0;
+    size_t size_ = 0;
+    Alloc alloc_;
+
+public:
+    stable_vector() = default;
+
+    explicit stable_vector(const Alloc& alloc) : alloc_(alloc) {}
+
+    // A throwing copy destroys the elements built so far and frees the
+    // blocks before the exception leaves the constructor.
+    stable_vector(size_t n, const T& value, const Alloc& alloc = Alloc()) : alloc_(alloc) {
+        try {
+            reserve(n);
+            for (size_t i = 0; i < n; ++i)
+                push_back(value);
+        } catch (...) {
+            clear();
+            deallocate_blocks(0);
+            throw;
+        }
+    }
+
+    stable_vector(const stable_vector& other)
+        : alloc_(traits::select_on_container_copy_construction(other.alloc_)) {
+        try {
+            append_from(other);
+        } catch (...) {
+            clear();
+            deallocate_blocks(0);
+            throw;
+        }
+    }
+
+    stable_vector(stable_vector&& other) noexcept : alloc_(std::move(other.alloc_)) {
+        steal(other);
+    }
+
+    // The allocator follows propagate_on_container_copy_assignment. When it
+    // does not propagate, the elements are copied into blocks from this
+    // vector's own allocator.
+    stable_vector& operator=(const stable_vector& other) {
+        if (this == &other) return *this;
+
+        if constexpr (traits::propagate_on_container_copy_assignment::value) {
+            if (!same_allocator(other)) {
+                stable_vector tmp(other.alloc_);
+                tmp.append_from(other);
+                clear();
+                deallocate_blocks(0);
+                alloc_ = other.alloc_;
+                steal(tmp);
+                return *this;
+            }
+            alloc_ = other.alloc_;
+        }
+
+        stable_vector tmp(alloc_);
+        tmp.append_from(other);
+        swap_storage(tmp);
+        return *this;
+    }
+
+    // Blocks from an allocator that neither propagates on move nor compares
+    // equal cannot be freed by ours, so the elements are moved one by one.
+    stable_vector& operator=(stable_vector&& other) noexcept(traits::propagate_on_container_move_assignment::value ||
+                                                             traits::is_always_equal::value) {
+        if (this == &other) return *this;
+
+        if constexpr (!traits::propagate_on_container_move_assignment::value) {
+            if (!same_allocator(other)) {
+                stable_vector tmp(alloc_);
+                tmp.reserve(other.size_);
+                for (size_t i = 0; i < other.size_; ++i)
+                    tmp.push_back(std::move(other[i]));
+                swap_storage(tmp);
+                return *this;
+            }
+        }
+
+        clear();
+        deallocate_blocks(0);
+        if constexpr (traits::propagate_on_container_move_assignment::value)
+            alloc_ = std::move(other.alloc_);
+        steal(other);
+        return *this;
+    }
+
+    ~stable_vector() {
+        clear();
+        deallocate_blocks(0);
+    }
+
+    // The allocators are exchanged only if propagate_on_container_swap is
+    // set; otherwise they must compare equal.
+    void swap(stable_vector& other) noexcept {
+        swap_storage(other);
+        if constexpr (traits::propagate_on_container_swap::value)
+            std::swap(alloc_, other.alloc_);
+    }
+
+    void reserve(size_t n) {
+        while (capacity() < n)
+            add_block();
+    }
+
+    // Releases whole blocks past the last element; never moves anything.
+    void shrink_to_fit() {
+        size_t needed = 0;
+        while (capacity_of(needed) < size_)
+            ++needed;
+        deallocate_blocks(needed);
+    }
+
+    void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    template <typename... Args>
+    reference emplace_back(Args&&... args) {
+        if (size_ == capacity()) add_block();
+
+        pointer slot = locate(size_);
+        std::construct_at(slot, std::forward<Args>(args)...);
+        ++size_;
+        return *slot;
+    }
+
+    void pop_back() noexcept {
+        if (size_ == 0) return;
+
+        --size_;
+        std::destroy_at(locate(size_));
+    }
+
+    void clear() noexcept {
+        while (size_ > 0) {
+            --size_;
+            std::destroy_at(locate(size_));
+        }
+    }
+
+    reference operator[](size_t i) { return *locate(i); }
+    constReference operator[](size_t i) const { return *locate(i); }
+
+    reference at(size_t ind) {
+        if (ind >= size_) throw std::out_of_range("Index is out of range");
+        return *locate(ind);
+    }
+
+    constReference at(size_t ind) const {
+        if (ind >= size_) throw std::out_of_range("Index is out of range");
+        return *locate(ind);
+    }
+
+    reference front() { return *locate(0); }
+    constReference front() const { return *locate(0); }
+    reference back() { return *locate(size_ - 1); }
+    constReference back() const { return *locate(size_ - 1); }
+
+    size_t size() const noexcept { return size_; }
+    size_t capacity() const noexcept { return capacity_of(block_count_); }
+    bool empty() const noexcept { return size_ == 0; }
+
+    Iterator begin() noexcept { return Iterator(this, 0); }
+    Iterator end() noexcept { return Iterator(this, size_); }
+
+    ConstIterator begin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator end() const noexcept { return ConstIterator(this, size_); }
+
+    ConstIterator cbegin() const noexcept { return ConstIterator(this, 0); }
+    ConstIterator cend() const noexcept { return ConstIterator(this, size_); }
+
+private:
+    static size_t block_size(size_t k) noexcept { return first_block << k; }
+
+    static size_t capacity_of(size_t blocks) noexcept {
+        return (first_block << blocks) - first_block;
+    }
+
+    pointer locate(size_t i) const noexcept {
+        size_t j = i + first_block;
+        size_t top = std::bit_width(j) - 1;
+        return blocks_[top - first_block_shift] + (j - (size_t(1) << top));
+    }
+
+    void add_block() {
+        if (block_count_ == max_blocks) throw std::length_error("stable_vector: too many elements");
+
+        blocks_[block_count_] = traits::allocate(alloc_, block_size(block_count_));
+        ++block_count_;
+    }
+
+    void deallocate_blocks(size_t keep) noexcept {
+        while (block_count_ > keep) {
+            --block_count_;
+            traits::deallocate(alloc_, blocks_[block_count_], block_size(block_count_));
+            blocks_[block_count_] = nullptr;
+        }
+    }
+
+    // Appends copies of other's elements. Callers own the cleanup if a
+    // copy throws.
+    void append_from(const stable_vector& other) {
+        reserve(other.size_);
+        for (size_t i = 0; i < other.size_; ++i)
+            push_back(other[i]);
+    }
+
+    void swap_storage(stable_vector& other) noexcept {
+        std::swap(blocks_, other.blocks_);
+        std::swap(block_count_, other.block_count_);
+        std::swap(size_, other.size_);
+    }
+
+    bool same_allocator(const stable_vector& other) const noexcept {
+        if constexpr (traits::is_always_equal::value)
+            return true;
+        else
+            return alloc_ == other.alloc_;
+    }
+
+    void steal(stable_vector& other) noexcept {
+        for (size_t k = 0; k < max_blocks; ++k) {
+            blocks_[k] = other.blocks_[k];
+            other.blocks_[k] = nullptr;
+        }
+        block_count_ = other.block_count_;
+        size_ = other.size_;
+        other.block_count_ = 0;
+        other.size_ = 0;
+    }
+};
@@ -4,6 +4,9 @@
 #include <type_traits>
 #include <initializer_list>
 
+#include "../tracing/growth_trace.h"
+#include "../tracing/memory_usage.h"
+
 template<typename T, typename Allocator = std::allocator<T>>
 class stack {
 public:
@@ -19,11 +22,13 @@ public:
     class iterator {
         friend class stack;
     private:
-        pointer ptr_;
+        T* ptr_;
         
     public:
         using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
         using value_type = T;
+        using element_type = T;
         using difference_type = std::ptrdiff_t;
         using pointer = T*;
         using reference = T&;
@@ -44,6 +49,7 @@ public:
         
         iterator operator+(difference_type n) const noexcept { return iterator(ptr_ + n); }
         iterator operator-(difference_type n) const noexcept { return iterator(ptr_ - n); }
+        friend iterator operator+(difference_type n, const iterator& it) noexcept { return it + n; }
         
         difference_type operator-(const iterator& other) const noexcept { return ptr_ - other.ptr_; }
         
@@ -64,7 +70,9 @@ public:
         
     public:
         using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::contiguous_iterator_tag;
         using value_type = T;
+        using element_type = const T;
         using difference_type = std::ptrdiff_t;
         using pointer = const T*;
         using reference = const T&;
@@ -86,6 +94,7 @@ public:
         
         const_iterator operator+(difference_type n) const noexcept { return const_iterator(ptr_ + n); }
         const_iterator operator-(difference_type n) const noexcept { return const_iterator(ptr_ - n); }
+        friend const_iterator operator+(difference_type n, const const_iterator& it) noexcept { return it + n; }
         
         difference_type operator-(const const_iterator& other) const noexcept { return ptr_ - other.ptr_; }
         
@@ -113,6 +122,7 @@ private:
     using alloc_traits = std::allocator_traits<allocator_type>;
     
     void grow() {
+        growth_trace trace(growth_site::stack, this, capacity_, sizeof(T));
         size_type new_capacity = capacity_ == 0 ? INITIAL_CAPACITY : capacity_ * 2;
         pointer new_data = alloc_traits::allocate(alloc_, new_capacity);
         
@@ -145,6 +155,7 @@ private:
         
         data_ = new_data;
         capacity_ = new_capacity;
+        trace.finish(new_capacity);
     }
     
     void destroy_all() noexcept {
@@ -156,6 +167,37 @@ private:
         }
     }
 
+    // destroy_all, leaving the stack empty with no storage.
+    void release() noexcept {
+        destroy_all();
+        data_ = nullptr;
+        size_ = 0;
+        capacity_ = 0;
+    }
+
+    // Appends copies of other's elements. Callers own the cleanup if a copy
+    // throws.
+    void append_from(const stack& other) {
+        reserve(size_ + other.size_);
+        for (size_type i = 0; i < other.size_; ++i) {
+            alloc_traits::construct(alloc_, data_ + size_, other.data_[i]);
+            ++size_;
+        }
+    }
+
+    void swap_storage(stack& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    bool same_allocator(const stack& other) const noexcept {
+        if constexpr (alloc_traits::is_always_equal::value)
+            return true;
+        else
+            return alloc_ == other.alloc_;
+    }
+
 public:
     explicit stack(const allocator_type& alloc = allocator_type()) 
         : data_(nullptr), size_(0), capacity_(0), alloc_(alloc) {}
@@ -204,26 +246,53 @@ public:
         destroy_all();
     }
     
+    // The allocator follows propagate_on_container_copy_assignment. When it
+    // does not propagate, the elements are copied into storage from this
+    // stack's own allocator.
     stack& operator=(const stack& other) {
-        if (this != &other) {
-            stack tmp(other);
-            swap(tmp);
+        if (this == &other) return *this;
+
+        if constexpr (alloc_traits::propagate_on_container_copy_assignment::value) {
+            if (!same_allocator(other)) {
+                stack tmp(other.alloc_);
+                tmp.append_from(other);
+                release();
+                alloc_ = other.alloc_;
+                swap_storage(tmp);
+                return *this;
+            }
+            alloc_ = other.alloc_;
         }
+
+        stack tmp(alloc_);
+        tmp.append_from(other);
+        swap_storage(tmp);
         return *this;
     }
     
-    stack& operator=(stack&& other) noexcept {
-        if (this != &other) {
-            destroy_all();
-            data_ = other.data_;
-            size_ = other.size_;
-            capacity_ = other.capacity_;
-            alloc_ = std::move(other.alloc_);
-            
-            other.data_ = nullptr;
-            other.size_ = 0;
-            other.capacity_ = 0;
+    // Storage from an allocator that neither propagates on move nor compares
+    // equal cannot be freed by ours, so the elements are moved one by one.
+    stack& operator=(stack&& other) noexcept(alloc_traits::propagate_on_container_move_assignment::value ||
+                                             alloc_traits::is_always_equal::value) {
+        if (this == &other) return *this;
+
+        if constexpr (!alloc_traits::propagate_on_container_move_assignment::value) {
+            if (!same_allocator(other)) {
+                stack tmp(alloc_);
+                tmp.reserve(other.size_);
+                for (size_type i = 0; i < other.size_; ++i) {
+                    alloc_traits::construct(tmp.alloc_, tmp.data_ + i, std::move(other.data_[i]));
+                    ++tmp.size_;
+                }
+                swap_storage(tmp);
+                return *this;
+            }
         }
+
+        release();
+        if constexpr (alloc_traits::propagate_on_container_move_assignment::value)
+            alloc_ = std::move(other.alloc_);
+        swap_storage(other);
         return *this;
     }
     
@@ -266,6 +335,12 @@ public:
     bool empty() const noexcept { return size_ == 0; }
     size_type size() const noexcept { return size_; }
     size_type capacity() const noexcept { return capacity_; }
+
+    memory_usage_breakdown memory_breakdown() const noexcept {
+        return {size_ * sizeof(T), 0, (capacity_ - size_) * sizeof(T)};
+    }
+
+    size_type memory_usage() const noexcept { return capacity_ * sizeof(T); }
     
     void reserve(size_type new_cap) {
         if (new_cap > capacity_) {
@@ -362,11 +437,12 @@ public:
         size_ = 0;
     }
     
+    // The allocators are exchanged only if propagate_on_container_swap is
+    // set; otherwise they must compare equal.
     void swap(stack& other) noexcept {
-        std::swap(data_, other.data_);
-        std::swap(size_, other.size_);
-        std::swap(capacity_, other.capacity_);
-        std::swap(alloc_, other.alloc_);
+        swap_storage(other);
+        if constexpr (alloc_traits::propagate_on_container_swap::value)
+            std::swap(alloc_, other.alloc_);
     }
     
     iterator begin() noexcept { return iterator(data_); }
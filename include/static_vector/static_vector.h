@@ -0,0 +1,304 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "../vector/vector.h"
+
+// vector with a fixed capacity of N elements stored inside the object; it
+// never allocates, and growing past N throws std::length_error. When T is
+// trivial the elements live in a plain T[N], which makes static_vector
+// usable in constant expressions (compile-time tables). Other element types
+// use raw aligned storage and are constructed and destroyed in place.
+// static_vector is trivially copyable whenever T is trivially copyable and
+// trivially destructible, including types with default member initializers.
+template <typename T, size_t N>
+class static_vector
+{
+    static_assert(N > 0, "static_vector requires a capacity of at least one element");
+
+    using pointer = T*;
+    using reference = T&;
+    using constReference = const T&;
+
+    static constexpr bool trivial_storage = std::is_trivial_v<T>;
+    static constexpr bool trivial_copy = std::is_trivially_copyable_v<T> && std::is_trivially_destructible_v<T>;
+
+    // Left uninitialized at run time, so a large static_vector costs nothing
+    // per slot to construct; see init_storage.
+    struct value_storage {
+        T elems[N];
+
+        constexpr pointer get() noexcept { return elems; }
+        constexpr const T* get() const noexcept { return elems; }
+    };
+
+    struct raw_storage {
+        alignas(T) unsigned char bytes[N * sizeof(T)];
+
+        pointer get() noexcept { return reinterpret_cast<pointer>(bytes); }
+        const T* get() const noexcept { return reinterpret_cast<const T*>(bytes); }
+    };
+
+public:
+    using Iterator = typename vector<T>::Iterator;
+    using ConstIterator = typename vector<T>::ConstIterator;
+
+private:
+    size_t size_ = 0;
+    std::conditional_t<trivial_storage, value_storage, raw_storage> storage_;
+
+public:
+    constexpr static_vector() noexcept {
+        init_storage();
+    }
+
+    constexpr static_vector(size_t n, const T& value) {
+        init_storage();
+        check_capacity(n);
+        for (; size_ < n; ++size_)
+            construct(data() + size_, value);
+    }
+
+    constexpr static_vector(std::initializer_list<T> values) {
+        init_storage();
+        check_capacity(values.size());
+        for (const T& value : values)
+            construct(data() + size_++, value);
+    }
+
+    constexpr static_vector(const static_vector&) requires trivial_copy = default;
+    constexpr static_vector(static_vector&&) requires trivial_copy = default;
+    constexpr static_vector& operator=(const static_vector&) requires trivial_copy = default;
+    constexpr static_vector& operator=(static_vector&&) requires trivial_copy = default;
+    constexpr ~static_vector() requires trivial_copy = default;
+
+    static_vector(const static_vector& other) requires (!trivial_copy) {
+        for (; size_ < other.size_; ++size_)
+            construct(data() + size_, other[size_]);
+    }
+
+    static_vector(static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T>)
+        requires (!trivial_copy) {
+        for (; size_ < other.size_; ++size_)
+            construct(data() + size_, std::move(other[size_]));
+        other.clear();
+    }
+
+    static_vector& operator=(const static_vector& other) requires (!trivial_copy) {
+        if (this != &other) assign_from(other.data(), other.size_);
+        return *this;
+    }
+
+    static_vector& operator=(static_vector&& other) noexcept(std::is_nothrow_move_constructible_v<T> &&
+                                                             std::is_nothrow_move_assignable_v<T>)
+        requires (!trivial_copy) {
+        if (this != &other) {
+            assign_from(std::make_move_iterator(other.data()), other.size_);
+            other.clear();
+        }
+        return *this;
+    }
+
+    ~static_vector() requires (!trivial_copy) {
+        clear();
+    }
+
+    constexpr void swap(static_vector& other) {
+        static_vector tmp(std::move(other));
+        other = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    // Only checks that n fits; the storage is always there.
+    constexpr void reserve(size_t n) const {
+        check_capacity(n);
+    }
+
+    constexpr void resize(size_t n) {
+        check_capacity(n);
+        destroy_tail(n);
+        for (; size_ < n; ++size_)
+            construct(data() + size_);
+    }
+
+    constexpr void resize(size_t n, const T& value) {
+        check_capacity(n);
+        destroy_tail(n);
+        for (; size_ < n; ++size_)
+            construct(data() + size_, value);
+    }
+
+    constexpr void push_back(const T& value) {
+        emplace_back(value);
+    }
+
+    constexpr void push_back(T&& value) {
+        emplace_back(std::move(value));
+    }
+
+    template <typename... Args>
+    constexpr void emplace_back(Args&&... args) {
+        check_capacity(size_ + 1);
+        construct(data() + size_, std::forward<Args>(args)...);
+        ++size_;
+    }
+
+    // Appends unless the vector is full; returns whether it did.
+    template <typename... Args>
+    constexpr bool try_emplace_back(Args&&... args) {
+        if (full()) return false;
+        construct(data() + size_, std::forward<Args>(args)...);
+        ++size_;
+        return true;
+    }
+
+    constexpr void pop_back() noexcept {
+        if (size_ == 0) return;
+
+        --size_;
+        destroy(data() + size_);
+    }
+
+    constexpr void clear() noexcept {
+        destroy_tail(0);
+    }
+
+    constexpr Iterator insert(ConstIterator pos, constReference value) {
+        check_capacity(size_ + 1);
+
+        size_t index = pos - cbegin();
+        T copy(value);
+        if (index == size_) {
+            construct(data() + size_, std::move(copy));
+        } else {
+            construct(data() + size_, std::move(data()[size_ - 1]));
+            std::move_backward(data() + index, data() + size_ - 1, data() + size_);
+            data()[index] = std::move(copy);
+        }
+        ++size_;
+        return begin() + index;
+    }
+
+    constexpr Iterator erase(ConstIterator pos) {
+        return erase(pos, pos + 1);
+    }
+
+    constexpr Iterator erase(ConstIterator first, ConstIterator last) {
+        size_t from = first - cbegin();
+        size_t to = last - cbegin();
+        if (from != to) {
+            std::move(data() + to, data() + size_, data() + from);
+            destroy_tail(size_ - (to - from));
+        }
+        return begin() + from;
+    }
+
+    template <typename Pred>
+    constexpr size_t erase_if(Pred pred) {
+        pointer kept = std::remove_if(data(), data() + size_, pred);
+        size_t removed = data() + size_ - kept;
+        destroy_tail(size_ - removed);
+        return removed;
+    }
+
+    // Removes pos by moving the last element into its place; O(1), but does
+    // not keep the order.
+    constexpr Iterator swap_remove(ConstIterator pos) {
+        size_t index = pos - cbegin();
+        if (index != size_ - 1) data()[index] = std::move(data()[size_ - 1]);
+        pop_back();
+        return begin() + index;
+    }
+
+    constexpr reference operator[](size_t i) { return data()[i]; }
+    constexpr constReference operator[](size_t i) const { return data()[i]; }
+
+    constexpr reference at(size_t ind) {
+        if (ind >= size_) throw std::out_of_range("Index is out of range");
+        return data()[ind];
+    }
+
+    constexpr constReference at(size_t ind) const {
+        if (ind >= size_) throw std::out_of_range("Index is out of range");
+        return data()[ind];
+    }
+
+    constexpr reference front() { return data()[0]; }
+    constexpr constReference front() const { return data()[0]; }
+    constexpr reference back() { return data()[size_ - 1]; }
+    constexpr constReference back() const { return data()[size_ - 1]; }
+
+    constexpr pointer data() noexcept { return storage_.get(); }
+    constexpr const T* data() const noexcept { return storage_.get(); }
+
+    constexpr size_t size() const noexcept { return size_; }
+    static constexpr size_t capacity() noexcept { return N; }
+    static constexpr size_t max_size() noexcept { return N; }
+    constexpr bool empty() const noexcept { return size_ == 0; }
+    constexpr bool full() const noexcept { return size_ == N; }
+
+    constexpr Iterator begin() noexcept { return Iterator(data()); }
+    constexpr Iterator end() noexcept { return Iterator(data() + size_); }
+
+    constexpr ConstIterator begin() const noexcept { return ConstIterator(data()); }
+    constexpr ConstIterator end() const noexcept { return ConstIterator(data() + size_); }
+
+    constexpr ConstIterator cbegin() const noexcept { return ConstIterator(data()); }
+    constexpr ConstIterator cend() const noexcept { return ConstIterator(data() + size_); }
+
+    friend constexpr bool operator==(const static_vector& a, const static_vector& b) {
+        return std::equal(a.data(), a.data() + a.size_, b.data(), b.data() + b.size_);
+    }
+
+private:
+    // A constant expression may not leave any slot of the T[N] array
+    // uninitialized, so the slots are value-initialized there and only there.
+    constexpr void init_storage() noexcept {
+        if constexpr (trivial_storage) {
+            if (std::is_constant_evaluated()) {
+                for (size_t i = 0; i < N; ++i)
+                    storage_.elems[i] = T();
+            }
+        }
+    }
+
+    static constexpr void check_capacity(size_t n) {
+        if (n > N) throw std::length_error("static_vector: capacity exceeded");
+    }
+
+    // Trivial elements already exist in the T[N] array, so they are assigned
+    // rather than constructed; that keeps every operation constexpr.
+    template <typename... Args>
+    constexpr void construct(pointer p, Args&&... args) {
+        if constexpr (trivial_storage)
+            *p = T(std::forward<Args>(args)...);
+        else
+            std::construct_at(p, std::forward<Args>(args)...);
+    }
+
+    constexpr void destroy(pointer p) noexcept {
+        if constexpr (!trivial_storage) std::destroy_at(p);
+    }
+
+    constexpr void destroy_tail(size_t n) noexcept {
+        while (size_ > n) {
+            --size_;
+            destroy(data() + size_);
+        }
+    }
+
+    template <typename InputIt>
+    void assign_from(InputIt src, size_t n) {
+        size_t common = std::min(size_, n);
+        std::copy_n(src, common, data());
+        destroy_tail(n);
+        for (src += common; size_ < n; ++size_, ++src)
+            construct(data() + size_, *src);
+    }
+};
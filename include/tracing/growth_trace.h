@@ -0,0 +1,262 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Growth tracing for the containers' reallocation points: vector::reallocate,
+// stack::grow, unordered_set::rehash_impl and deque::resize_map. Each growth
+// is reported to the installed hook as a growth_event giving the old and new
+// capacity, the bytes of the old and new buffers and the time the growth
+// took, so stalls can be lined up against latency spikes.
+//
+// Tracing is compiled in only when CONTAINERS_ENABLE_TRACING is defined
+// before the containers are included. Otherwise growth_trace is an empty
+// object and the containers contain no tracing code at all. When enabled,
+// a growth with no hook installed costs one atomic load.
+//
+// The default hook, growth_histogram_hook, aggregates log2 histograms of
+// growth time and size per container kind; read them from
+// growth_histograms(). usdt_growth_hook fires a containers:growth USDT
+// probe instead, for perf, bpftrace or SystemTap.
+
+enum class growth_site : uint8_t { vector, stack, unordered_set, deque };
+
+inline constexpr size_t growth_site_count = 4;
+
+constexpr const char* growth_site_name(growth_site site) noexcept {
+    constexpr const char* names[] = {"vector", "stack", "unordered_set", "deque"};
+    return names[static_cast<size_t>(site)];
+}
+
+// Capacities count elements, except buckets for unordered_set and map slots
+// for deque.
+struct growth_event {
+    growth_site site;
+    const void* object;
+    size_t old_capacity;
+    size_t new_capacity;
+    size_t old_bytes;
+    size_t new_bytes;
+    uint64_t elapsed_ns;
+};
+
+// Hooks are called on the growing thread and must not throw.
+using growth_hook = void (*)(const growth_event&) noexcept;
+
+// Aggregated growth statistics for one container kind. Bucket i of a
+// histogram counts values v with bit_width(v) == i, so bucket i covers
+// [2^(i-1), 2^i).
+struct growth_stats {
+    static constexpr size_t buckets = 65;
+
+    uint64_t count = 0;
+    uint64_t bytes = 0;  // sum of new_bytes
+    uint64_t total_ns = 0;
+    uint64_t max_ns = 0;
+    uint64_t time_ns[buckets] = {};
+    uint64_t size_bytes[buckets] = {};
+
+    // Upper bound of the growth time at quantile q (0.99 for p99), to the
+    // precision of the histogram.
+    uint64_t percentile_ns(double q) const noexcept {
+        uint64_t rank = static_cast<uint64_t>(q * count);
+        uint64_t seen = 0;
+        for (size_t i = 0; i < buckets; ++i) {
+            seen += time_ns[i];
+            if (seen > rank) return i == 0 ? 0 : i >= 64 ? max_ns : std::min((uint64_t(1) << i) - 1, max_ns);
+        }
+        return max_ns;
+    }
+};
+
+// Lock-free accumulation of growth_events; record can be called from any
+// number of threads.
+class growth_histogram
+{
+    struct counters {
+        std::atomic<uint64_t> count{0};
+        std::atomic<uint64_t> bytes{0};
+        std::atomic<uint64_t> total_ns{0};
+        std::atomic<uint64_t> max_ns{0};
+        std::atomic<uint64_t> time_ns[growth_stats::buckets] = {};
+        std::atomic<uint64_t> size_bytes[growth_stats::buckets] = {};
+    };
+
+    counters sites_[growth_site_count];
+
+    static size_t bucket(uint64_t v) noexcept {
+        size_t width = 0;
+        for (; v; v >>= 1)
+            ++width;
+        return width;
+    }
+
+public:
+    void record(const growth_event& e) noexcept {
+        counters& c = sites_[static_cast<size_t>(e.site)];
+        c.count.fetch_add(1, std::memory_order_relaxed);
+        c.bytes.fetch_add(e.new_bytes, std::memory_order_relaxed);
+        c.total_ns.fetch_add(e.elapsed_ns, std::memory_order_relaxed);
+        c.time_ns[bucket(e.elapsed_ns)].fetch_add(1, std::memory_order_relaxed);
+        c.size_bytes[bucket(e.new_bytes)].fetch_add(1, std::memory_order_relaxed);
+
+        uint64_t max = c.max_ns.load(std::memory_order_relaxed);
+        while (e.elapsed_ns > max && !c.max_ns.compare_exchange_weak(max, e.elapsed_ns, std::memory_order_relaxed)) {
+        }
+    }
+
+    // A copy of the counters for one kind; concurrent records may be
+    // partly included.
+    growth_stats stats(growth_site site) const noexcept {
+        const counters& c = sites_[static_cast<size_t>(site)];
+        growth_stats s;
+        s.count = c.count.load(std::memory_order_relaxed);
+        s.bytes = c.bytes.load(std::memory_order_relaxed);
+        s.total_ns = c.total_ns.load(std::memory_order_relaxed);
+        s.max_ns = c.max_ns.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < growth_stats::buckets; ++i) {
+            s.time_ns[i] = c.time_ns[i].load(std::memory_order_relaxed);
+            s.size_bytes[i] = c.size_bytes[i].load(std::memory_order_relaxed);
+        }
+        return s;
+    }
+
+    void reset() noexcept {
+        for (counters& c : sites_) {
+            c.count.store(0, std::memory_order_relaxed);
+            c.bytes.store(0, std::memory_order_relaxed);
+            c.total_ns.store(0, std::memory_order_relaxed);
+            c.max_ns.store(0, std::memory_order_relaxed);
+            for (size_t i = 0; i < growth_stats::buckets; ++i) {
+                c.time_ns[i].store(0, std::memory_order_relaxed);
+                c.size_bytes[i].store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // One line per container kind that grew: count, bytes, mean, p50, p99
+    // and max growth time.
+    void print(std::ostream& os) const {
+        for (size_t i = 0; i < growth_site_count; ++i) {
+            growth_site site = static_cast<growth_site>(i);
+            growth_stats s = stats(site);
+            if (s.count == 0) continue;
+
+            os << growth_site_name(site) << ": " << s.count << " growths, " << s.bytes << " bytes, mean "
+               << s.total_ns / s.count << " ns, p50 <= " << s.percentile_ns(0.5) << " ns, p99 <= "
+               << s.percentile_ns(0.99) << " ns, max " << s.max_ns << " ns\n";
+        }
+    }
+};
+
+inline growth_histogram& growth_histograms() noexcept {
+    static growth_histogram histograms;
+    return histograms;
+}
+
+inline void growth_histogram_hook(const growth_event& e) noexcept {
+    growth_histograms().record(e);
+}
+
+#if defined(__linux__) && (defined(__x86_64__) || defined(__aarch64__)) && (defined(__GNUC__) || defined(__clang__))
+#define CONTAINERS_HAS_USDT 1
+#endif
+
+// Fires the USDT probe containers:growth with arguments (container name,
+// object, old capacity, new capacity, old bytes, new bytes, elapsed ns).
+// The probe is a nop plus an ELF .note.stapsdt entry in the format of
+// <sys/sdt.h>, written out here so no systemtap headers are needed. List it
+// with `perf list sdt_containers:*` after `perf buildid-cache --add <binary>`,
+// or attach with `bpftrace -e 'usdt:<binary>:containers:growth { ... }'`.
+// Elsewhere the hook does nothing.
+inline void usdt_growth_hook(const growth_event& e) noexcept {
+#if defined(CONTAINERS_HAS_USDT)
+    const char* name = growth_site_name(e.site);
+    __asm__ __volatile__(
+        "990: nop\n"
+        ".pushsection .note.stapsdt,\"?\",\"note\"\n"
+        ".balign 4\n"
+        ".4byte 992f-991f, 994f-993f, 3\n"
+        "991: .asciz \"stapsdt\"\n"
+        "992: .balign 4\n"
+        "993: .8byte 990b\n"
+        ".8byte _.stapsdt.base\n"
+        ".8byte 0\n"
+        ".asciz \"containers\"\n"
+        ".asciz \"growth\"\n"
+        ".asciz \"8@%0 8@%1 8@%2 8@%3 8@%4 8@%5 8@%6\"\n"
+        "994: .balign 4\n"
+        ".popsection\n"
+        ".ifndef _.stapsdt.base\n"
+        ".pushsection .stapsdt.base,\"aG\",\"progbits\",.stapsdt.base,comdat\n"
+        ".weak _.stapsdt.base\n"
+        ".hidden _.stapsdt.base\n"
+        "_.stapsdt.base: .space 1\n"
+        ".size _.stapsdt.base, 1\n"
+        ".popsection\n"
+        ".endif\n"
+        :
+        : "nor"(name), "nor"(e.object), "nor"(e.old_capacity), "nor"(e.new_capacity), "nor"(e.old_bytes),
+          "nor"(e.new_bytes), "nor"(e.elapsed_ns));
+#else
+    (void)e;
+#endif
+}
+
+inline std::atomic<growth_hook>& growth_hook_slot() noexcept {
+    static std::atomic<growth_hook> hook{&growth_histogram_hook};
+    return hook;
+}
+
+// Installs hook for all containers and returns the previous one. nullptr
+// turns reporting off.
+inline growth_hook set_growth_hook(growth_hook hook) noexcept {
+    return growth_hook_slot().exchange(hook, std::memory_order_acq_rel);
+}
+
+// Times one growth. Construct it before allocating and call finish with the
+// capacity obtained once the elements have moved; a growth that throws is
+// not reported.
+#if defined(CONTAINERS_ENABLE_TRACING)
+class growth_trace
+{
+    growth_hook hook_;
+    growth_site site_;
+    const void* object_;
+    size_t old_capacity_;
+    size_t element_size_;
+    std::chrono::steady_clock::time_point start_;
+
+public:
+    growth_trace(growth_site site, const void* object, size_t old_capacity, size_t element_size) noexcept
+        : hook_(growth_hook_slot().load(std::memory_order_acquire)), site_(site), object_(object),
+          old_capacity_(old_capacity), element_size_(element_size) {
+        if (hook_) start_ = std::chrono::steady_clock::now();
+    }
+
+    void finish(size_t new_capacity) noexcept {
+        if (!hook_) return;
+
+        auto elapsed = std::chrono::steady_clock::now() - start_;
+        growth_event e{site_,
+                       object_,
+                       old_capacity_,
+                       new_capacity,
+                       old_capacity_ * element_size_,
+                       new_capacity * element_size_,
+                       static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count())};
+        hook_(e);
+    }
+};
+#else
+class growth_trace
+{
+public:
+    constexpr growth_trace(growth_site, const void*, size_t, size_t) noexcept {}
+    constexpr void finish(size_t) noexcept {}
+};
+#endif
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+// Heap bytes held by a container, as returned by memory_breakdown().
+// payload is sizeof(T) per element; overhead is memory that holds no
+// elements by design (list and hash node links, hash buckets, the deque
+// map); slack is element storage allocated but not in use (vector and
+// stack capacity, the unused ends of deque segments). The container object
+// itself and the allocator's own per-block headers are not counted.
+struct memory_usage_breakdown {
+    size_t payload = 0;
+    size_t overhead = 0;
+    size_t slack = 0;
+
+    size_t total() const noexcept { return payload + overhead + slack; }
+};
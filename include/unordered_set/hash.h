@@ -0,0 +1,176 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <random>
+#include <string_view>
+#include <type_traits>
+
+// Hash functors for use as the Hash parameter of unordered_set.
+//
+//   wyhash          - fast byte-string hash (wyhash v4), fixed seed
+//   random_wyhash   - wyhash with a random seed drawn per instance, for keys
+//                     that come from untrusted input
+//   mix_hash        - 64-bit finalizer for integers, enums and pointers
+//   random_mix_hash - mix_hash with a random seed drawn per instance
+//
+// A randomly seeded functor is copied along with the set that owns it, so
+// copies of a set keep hashing consistently.
+
+struct hash_detail {
+    static constexpr uint64_t secret[4] = {
+        0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+        0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull
+    };
+
+    static void mum(uint64_t& a, uint64_t& b) noexcept {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t r = static_cast<__uint128_t>(a) * b;
+        a = static_cast<uint64_t>(r);
+        b = static_cast<uint64_t>(r >> 64);
+#else
+        uint64_t ha = a >> 32, hb = b >> 32, la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+        uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        uint64_t t = rl + (rm0 << 32);
+        uint64_t c = t < rl;
+        uint64_t lo = t + (rm1 << 32);
+        c += lo < t;
+        uint64_t hi = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+        a = lo;
+        b = hi;
+#endif
+    }
+
+    static uint64_t mix(uint64_t a, uint64_t b) noexcept {
+        mum(a, b);
+        return a ^ b;
+    }
+
+    static uint64_t read8(const unsigned char* p) noexcept {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+
+    static uint64_t read4(const unsigned char* p) noexcept {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    static uint64_t read3(const unsigned char* p, size_t k) noexcept {
+        return (static_cast<uint64_t>(p[0]) << 16) |
+               (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+    }
+};
+
+inline uint64_t hash_bytes(const void* key, size_t len, uint64_t seed = 0) noexcept {
+    using d = hash_detail;
+    const unsigned char* p = static_cast<const unsigned char*>(key);
+    seed ^= d::mix(seed ^ d::secret[0], d::secret[1]);
+    uint64_t a, b;
+
+    if (len <= 16) {
+        if (len >= 4) {
+            a = (d::read4(p) << 32) | d::read4(p + ((len >> 3) << 2));
+            b = (d::read4(p + len - 4) << 32) | d::read4(p + len - 4 - ((len >> 3) << 2));
+        } else if (len > 0) {
+            a = d::read3(p, len);
+            b = 0;
+        } else {
+            a = b = 0;
+        }
+    } else {
+        size_t i = len;
+        if (i > 48) {
+            uint64_t see1 = seed, see2 = seed;
+            do {
+                seed = d::mix(d::read8(p) ^ d::secret[1], d::read8(p + 8) ^ seed);
+                see1 = d::mix(d::read8(p + 16) ^ d::secret[2], d::read8(p + 24) ^ see1);
+                see2 = d::mix(d::read8(p + 32) ^ d::secret[3], d::read8(p + 40) ^ see2);
+                p += 48;
+                i -= 48;
+            } while (i > 48);
+            seed ^= see1 ^ see2;
+        }
+        while (i > 16) {
+            seed = d::mix(d::read8(p) ^ d::secret[1], d::read8(p + 8) ^ seed);
+            i -= 16;
+            p += 16;
+        }
+        a = d::read8(p + i - 16);
+        b = d::read8(p + i - 8);
+    }
+
+    a ^= d::secret[1];
+    b ^= seed;
+    d::mum(a, b);
+    return d::mix(a ^ d::secret[0] ^ len, b ^ d::secret[1]);
+}
+
+inline uint64_t mix64(uint64_t x) noexcept {
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+// Process-wide entropy drawn once, combined with a counter so that every call
+// returns a distinct, unpredictable seed without touching random_device again.
+inline uint64_t random_hash_seed() noexcept {
+    static const uint64_t base = [] {
+        uint64_t s = static_cast<uint64_t>(
+            std::chrono::steady_clock::now().time_since_epoch().count());
+        try {
+            std::random_device rd;
+            s ^= (static_cast<uint64_t>(rd()) << 32) ^ rd();
+        } catch (...) {
+        }
+        return mix64(s);
+    }();
+    static std::atomic<uint64_t> counter{0};
+    return mix64(base + counter.fetch_add(0x9e3779b97f4a7c15ull, std::memory_order_relaxed));
+}
+
+struct wyhash {
+    uint64_t seed;
+
+    explicit wyhash(uint64_t s = 0) noexcept : seed(s) {}
+
+    size_t operator()(std::string_view s) const noexcept {
+        return static_cast<size_t>(hash_bytes(s.data(), s.size(), seed));
+    }
+};
+
+struct random_wyhash : wyhash {
+    random_wyhash() noexcept : wyhash(random_hash_seed()) {}
+    explicit random_wyhash(uint64_t s) noexcept : wyhash(s) {}
+};
+
+struct mix_hash {
+    uint64_t seed;
+
+    explicit mix_hash(uint64_t s = 0) noexcept : seed(s) {}
+
+    template<typename Key, typename = std::enable_if_t<
+        std::is_integral_v<Key> || std::is_enum_v<Key> || std::is_pointer_v<Key>>>
+    size_t operator()(Key key) const noexcept {
+        uint64_t bits;
+        if constexpr (std::is_pointer_v<Key>) {
+            bits = reinterpret_cast<uintptr_t>(key);
+        } else {
+            bits = static_cast<uint64_t>(key);
+        }
+        return static_cast<size_t>(mix64(bits ^ seed));
+    }
+};
+
+struct random_mix_hash : mix_hash {
+    random_mix_hash() noexcept : mix_hash(random_hash_seed()) {}
+    explicit random_mix_hash(uint64_t s) noexcept : mix_hash(s) {}
+};
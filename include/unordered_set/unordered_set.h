@@ -5,6 +5,9 @@
 #include <initializer_list>
 #include <algorithm>
 
+#include "../tracing/growth_trace.h"
+#include "../tracing/memory_usage.h"
+
 template<typename Value>
 struct hash_node {
     Value value;
@@ -109,6 +112,7 @@ private:
     using node_type = hash_node<Key>;
     using node_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<node_type>;
     using bucket_allocator = typename std::allocator_traits<Allocator>::template rebind_alloc<node_type*>;
+    using node_traits = std::allocator_traits<node_allocator>;
     
     node_type** buckets_;
     size_type bucket_count_;
@@ -160,6 +164,7 @@ private:
             new_bucket_count = static_cast<size_type>(size_ / max_load_factor_) + 1;
         }
         
+        growth_trace trace(growth_site::unordered_set, this, bucket_count_, sizeof(node_type*));
         node_type** new_buckets = bucket_alloc_.allocate(new_bucket_count);
         for (size_type i = 0; i < new_bucket_count; ++i) {
             new_buckets[i] = nullptr;
@@ -179,8 +184,34 @@ private:
         deallocate_buckets();
         buckets_ = new_buckets;
         bucket_count_ = new_bucket_count;
+        trace.finish(new_bucket_count);
     }
     
+    // An empty set with other's bucket count, hash, equality and load
+    // factor, allocating from alloc.
+    unordered_set empty_like(const unordered_set& other, const Allocator& alloc) const {
+        unordered_set result(other.bucket_count_, other.hash_, other.equal_, alloc);
+        result.max_load_factor_ = other.max_load_factor_;
+        return result;
+    }
+
+    // Everything but the allocators.
+    void swap_storage(unordered_set& other) noexcept {
+        std::swap(buckets_, other.buckets_);
+        std::swap(bucket_count_, other.bucket_count_);
+        std::swap(size_, other.size_);
+        std::swap(max_load_factor_, other.max_load_factor_);
+        std::swap(hash_, other.hash_);
+        std::swap(equal_, other.equal_);
+    }
+
+    bool same_allocator(const unordered_set& other) const noexcept {
+        if constexpr (node_traits::is_always_equal::value)
+            return true;
+        else
+            return node_alloc_ == other.node_alloc_;
+    }
+
     void check_and_rehash() {
         if (static_cast<float>(size_ + 1) > bucket_count_ * max_load_factor_) {
             rehash_impl(bucket_count_ * 2);
@@ -194,6 +225,9 @@ public:
         allocate_buckets(default_bucket_count);
     }
     
+    explicit unordered_set(const Allocator& alloc)
+        : unordered_set(default_bucket_count, Hash(), KeyEqual(), alloc) {}
+    
     explicit unordered_set(size_type bucket_count,
                           const Hash& hash = Hash(),
                           const KeyEqual& equal = KeyEqual(),
@@ -242,32 +276,66 @@ public:
         deallocate_buckets();
     }
     
+    // The allocator follows propagate_on_container_copy_assignment. When it
+    // does not propagate, the nodes are copied with this set's own
+    // allocator.
     unordered_set& operator=(const unordered_set& other) {
-        if (this != &other) {
-            unordered_set tmp(other);
-            swap(tmp);
+        if (this == &other) return *this;
+
+        if constexpr (node_traits::propagate_on_container_copy_assignment::value) {
+            if (!same_allocator(other)) {
+                unordered_set tmp = empty_like(other, Allocator(other.node_alloc_));
+                for (const auto& val : other) {
+                    tmp.insert(val);
+                }
+                clear_all_nodes();
+                deallocate_buckets();
+                bucket_count_ = 0;
+                node_alloc_ = other.node_alloc_;
+                bucket_alloc_ = other.bucket_alloc_;
+                swap_storage(tmp);
+                return *this;
+            }
+            node_alloc_ = other.node_alloc_;
+            bucket_alloc_ = other.bucket_alloc_;
         }
+
+        unordered_set tmp = empty_like(other, Allocator(node_alloc_));
+        for (const auto& val : other) {
+            tmp.insert(val);
+        }
+        swap_storage(tmp);
         return *this;
     }
     
-    unordered_set& operator=(unordered_set&& other) noexcept {
-        if (this != &other) {
-            clear_all_nodes();
-            deallocate_buckets();
-            
-            buckets_ = other.buckets_;
-            bucket_count_ = other.bucket_count_;
-            size_ = other.size_;
-            max_load_factor_ = other.max_load_factor_;
-            hash_ = std::move(other.hash_);
-            equal_ = std::move(other.equal_);
+    // Nodes from an allocator that neither propagates on move nor compares
+    // equal cannot be freed by ours, so the values are moved into new nodes.
+    unordered_set& operator=(unordered_set&& other) noexcept(
+        node_traits::propagate_on_container_move_assignment::value || node_traits::is_always_equal::value) {
+        if (this == &other) return *this;
+
+        if constexpr (!node_traits::propagate_on_container_move_assignment::value) {
+            if (!same_allocator(other)) {
+                unordered_set tmp = empty_like(other, Allocator(node_alloc_));
+                for (size_type i = 0; i < other.bucket_count_; ++i) {
+                    for (node_type* node = other.buckets_[i]; node; node = node->next) {
+                        tmp.insert(std::move(node->value));
+                    }
+                }
+                other.clear_all_nodes();
+                swap_storage(tmp);
+                return *this;
+            }
+        }
+
+        clear_all_nodes();
+        deallocate_buckets();
+        bucket_count_ = 0;
+        if constexpr (node_traits::propagate_on_container_move_assignment::value) {
             node_alloc_ = std::move(other.node_alloc_);
             bucket_alloc_ = std::move(other.bucket_alloc_);
-            
-            other.buckets_ = nullptr;
-            other.bucket_count_ = 0;
-            other.size_ = 0;
         }
+        swap_storage(other);
         return *this;
     }
     
@@ -407,15 +475,14 @@ public:
         return 0;
     }
     
+    // The allocators are exchanged only if propagate_on_container_swap is
+    // set; otherwise they must compare equal.
     void swap(unordered_set& other) noexcept {
-        std::swap(buckets_, other.buckets_);
-        std::swap(bucket_count_, other.bucket_count_);
-        std::swap(size_, other.size_);
-        std::swap(max_load_factor_, other.max_load_factor_);
-        std::swap(hash_, other.hash_);
-        std::swap(equal_, other.equal_);
-        std::swap(node_alloc_, other.node_alloc_);
-        std::swap(bucket_alloc_, other.bucket_alloc_);
+        swap_storage(other);
+        if constexpr (node_traits::propagate_on_container_swap::value) {
+            std::swap(node_alloc_, other.node_alloc_);
+            std::swap(bucket_alloc_, other.bucket_alloc_);
+        }
     }
     
     size_type count(const key_type& key) const {
@@ -453,6 +520,13 @@ public:
     }
     
     size_type bucket_count() const { return bucket_count_; }
+
+    // Bucket heads and each node's next pointer and padding are overhead.
+    memory_usage_breakdown memory_breakdown() const noexcept {
+        return {size_ * sizeof(Key), bucket_count_ * sizeof(node_type*) + size_ * (sizeof(node_type) - sizeof(Key)), 0};
+    }
+
+    size_type memory_usage() const noexcept { return memory_breakdown().total(); }
     size_type max_bucket_count() const { 
         return std::allocator_traits<bucket_allocator>::max_size(bucket_alloc_); 
     }
@@ -0,0 +1,108 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#if defined(__GLIBC__) || defined(__linux__)
+#include <malloc.h>
+#define VECTOR_HAS_MALLOC_USABLE_SIZE 1
+#elif defined(__APPLE__)
+#include <malloc/malloc.h>
+#define VECTOR_HAS_MALLOC_SIZE 1
+#endif
+
+// Growth policies for vector's third template parameter. next_capacity maps
+// the current capacity to the one requested on the next reallocation.
+//
+// growth_size_class grows by 1.5x and then keeps whatever the allocator
+// actually handed back, so the slack of the allocator's size class becomes
+// usable capacity. That needs an allocator exposing allocate_at_least
+// (malloc_allocator below, or any C++23 allocator); with others it behaves
+// like growth_golden.
+
+struct growth_double {
+    static constexpr bool uses_size_classes = false;
+
+    static constexpr size_t next_capacity(size_t capacity) noexcept {
+        return capacity == 0 ? 1 : 2 * capacity;
+    }
+};
+
+struct growth_golden {
+    static constexpr bool uses_size_classes = false;
+
+    static constexpr size_t next_capacity(size_t capacity) noexcept {
+        return capacity == 0 ? 1 : capacity + (capacity + 1) / 2;
+    }
+};
+
+struct growth_size_class {
+    static constexpr bool uses_size_classes = true;
+
+    static constexpr size_t next_capacity(size_t capacity) noexcept {
+        return growth_golden::next_capacity(capacity);
+    }
+};
+
+template <typename Pointer>
+struct allocation {
+    Pointer ptr;
+    size_t count;
+};
+
+template <typename Alloc>
+allocation<typename std::allocator_traits<Alloc>::pointer> allocate_at_least(Alloc& alloc, size_t n) {
+    if constexpr (requires { alloc.allocate_at_least(n); }) {
+        auto result = alloc.allocate_at_least(n);
+        return {result.ptr, result.count};
+    } else {
+        return {std::allocator_traits<Alloc>::allocate(alloc, n), n};
+    }
+}
+
+// malloc/free based allocator that reports the usable size of each block, so
+// vector<T, malloc_allocator<T>, growth_size_class> can use the size-class
+// slack. Only suitable for types whose alignment malloc already guarantees.
+template <typename T>
+class malloc_allocator {
+public:
+    using value_type = T;
+
+    malloc_allocator() noexcept = default;
+
+    template <typename U>
+    malloc_allocator(const malloc_allocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        void* p = std::malloc(n * sizeof(T));
+        if (!p && n != 0) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    allocation<T*> allocate_at_least(size_t n) {
+        T* p = allocate(n);
+        return {p, usable_count(p, n)};
+    }
+
+    void deallocate(T* p, size_t) noexcept { std::free(p); }
+
+    template <typename U>
+    bool operator==(const malloc_allocator<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const malloc_allocator<U>&) const noexcept { return false; }
+
+private:
+    static size_t usable_count(T* p, size_t n) noexcept {
+        if (!p) return n;
+#if defined(VECTOR_HAS_MALLOC_USABLE_SIZE)
+        return malloc_usable_size(p) / sizeof(T);
+#elif defined(VECTOR_HAS_MALLOC_SIZE)
+        return malloc_size(p) / sizeof(T);
+#else
+        return n;
+#endif
+    }
+};
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <memory>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <sys/mman.h>
+#include <unistd.h>
+
+// Allocator for very large vectors. Blocks below mmap_threshold come from
+// malloc; larger ones are anonymous mappings advised for transparent huge
+// pages. vector calls reallocate() instead of allocate/move/deallocate when
+// the element type is trivially copyable, which on Linux becomes an mremap:
+// the kernel extends the mapping in place or moves its pages, so growth never
+// copies the payload or needs old and new buffers resident at once.
+template <typename T>
+class mmap_allocator {
+public:
+    using value_type = T;
+
+    static constexpr size_t mmap_threshold = size_t(2) << 20;
+
+    mmap_allocator() noexcept = default;
+
+    template <typename U>
+    mmap_allocator(const mmap_allocator<U>&) noexcept {}
+
+    T* allocate(size_t n) {
+        size_t bytes = n * sizeof(T);
+        if (bytes < mmap_threshold) return small_allocate(bytes);
+        return static_cast<T*>(map(bytes));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        if (!p) return;
+
+        size_t bytes = n * sizeof(T);
+        if (bytes < mmap_threshold)
+            std::free(p);
+        else
+            ::munmap(p, page_round(bytes));
+    }
+
+    T* reallocate(T* p, size_t old_n, size_t new_n) {
+        size_t old_bytes = old_n * sizeof(T);
+        size_t new_bytes = new_n * sizeof(T);
+        bool old_mapped = old_bytes >= mmap_threshold;
+        bool new_mapped = new_bytes >= mmap_threshold;
+
+        if (!old_mapped && !new_mapped) {
+            void* q = std::realloc(p, new_bytes);
+            if (!q && new_bytes != 0) throw std::bad_alloc();
+            return static_cast<T*>(q);
+        }
+
+#if defined(__linux__)
+        if (old_mapped && new_mapped) {
+            void* q = ::mremap(p, page_round(old_bytes), page_round(new_bytes), MREMAP_MAYMOVE);
+            if (q == MAP_FAILED) throw std::bad_alloc();
+            advise(q, page_round(new_bytes));
+            return static_cast<T*>(q);
+        }
+#endif
+
+        T* q = allocate(new_n);
+        std::memcpy(q, p, old_bytes < new_bytes ? old_bytes : new_bytes);
+        deallocate(p, old_n);
+        return q;
+    }
+
+    template <typename U>
+    bool operator==(const mmap_allocator<U>&) const noexcept { return true; }
+
+    template <typename U>
+    bool operator!=(const mmap_allocator<U>&) const noexcept { return false; }
+
+private:
+    static size_t page_round(size_t bytes) noexcept {
+        static const size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+        return (bytes + page - 1) & ~(page - 1);
+    }
+
+    static T* small_allocate(size_t bytes) {
+        void* p = std::malloc(bytes);
+        if (!p && bytes != 0) throw std::bad_alloc();
+        return static_cast<T*>(p);
+    }
+
+    static void* map(size_t bytes) {
+        size_t len = page_round(bytes);
+        void* p = ::mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (p == MAP_FAILED) throw std::bad_alloc();
+        advise(p, len);
+        return p;
+    }
+
+    static void advise(void* p, size_t len) noexcept {
+#if defined(MADV_HUGEPAGE)
+        ::madvise(p, len, MADV_HUGEPAGE);
+#else
+        (void)p;
+        (void)len;
+#endif
+    }
+};
@@ -1,9 +1,22 @@
+#pragma once
+
 #include <memory>
 #include <cstddef>
 #include <utility>
 #include <iostream>
-
-template <typename T, typename Alloc = std::allocator<T>>
+#include <stdexcept>
+#include <new>
+#include <cstring>
+#include <type_traits>
+#include <algorithm>
+#include <span>
+#include <iterator>
+
+#include "growth_policy.h"
+#include "../tracing/growth_trace.h"
+#include "../tracing/memory_usage.h"
+
+template <typename T, typename Alloc = std::allocator<T>, typename Growth = growth_double>
 class vector 
 {
     using traits = std::allocator_traits<Alloc>;
@@ -12,11 +25,15 @@ class vector
     using constReference = const T&;
 
 public:
+    class ConstIterator;
+
     class Iterator {
     public:
+        using iterator_concept = std::contiguous_iterator_tag;
         using iterator_category = std::random_access_iterator_tag;
         using difference_type = std::ptrdiff_t;
         using value_type = T;
+        using element_type = T;
         using pointer = T*;
         using reference = T&;
 
@@ -24,38 +41,46 @@ public:
         pointer ptr;
 
     public:
-        explicit Iterator(pointer p) : ptr(p) {}
+        constexpr Iterator() : ptr(nullptr) {}
+        constexpr explicit Iterator(pointer p) : ptr(p) {}
+
+        constexpr reference operator*() const { return *ptr; }
+        constexpr pointer operator->() const { return ptr; }
 
-        reference operator*() const { return *ptr; }
-        pointer operator->() const { return ptr; }
+        constexpr Iterator& operator++() { ++ptr; return *this; }       
+        constexpr Iterator operator++(int) { Iterator temp = *this; ++ptr; return temp; } 
 
-        Iterator& operator++() { ++ptr; return *this; }       
-        Iterator operator++(int) { Iterator temp = *this; ++ptr; return temp; } 
+        constexpr Iterator& operator--() { --ptr; return *this; }     
+        constexpr Iterator operator--(int) { Iterator temp = *this; --ptr; return temp; } 
 
-        Iterator& operator--() { --ptr; return *this; }     
-        Iterator operator--(int) { Iterator temp = *this; --ptr; return temp; } 
+        constexpr reference operator[](difference_type n) const { return ptr[n]; }
 
-        reference operator[](difference_type n) const { return ptr[n]; }
+        constexpr Iterator& operator+=(difference_type n) { ptr += n; return *this; }
+        constexpr Iterator& operator-=(difference_type n) { ptr -= n; return *this; }
 
-        Iterator operator+(difference_type n) const { return Iterator(ptr + n); }
-        Iterator operator-(difference_type n) const { return Iterator(ptr - n); }
-        difference_type operator-(const Iterator& other) const { return ptr - other.ptr; }
+        constexpr Iterator operator+(difference_type n) const { return Iterator(ptr + n); }
+        constexpr Iterator operator-(difference_type n) const { return Iterator(ptr - n); }
+        constexpr difference_type operator-(const Iterator& other) const { return ptr - other.ptr; }
 
-        bool operator==(const Iterator& other) const { return ptr == other.ptr; }
-        bool operator!=(const Iterator& other) const { return ptr != other.ptr; }
-        bool operator<(const Iterator& other) const { return ptr < other.ptr; }
-        bool operator>(const Iterator& other) const { return ptr > other.ptr; }
-        bool operator<=(const Iterator& other) const { return ptr <= other.ptr; }
-        bool operator>=(const Iterator& other) const { return ptr >= other.ptr; }
+        constexpr bool operator==(const Iterator& other) const { return ptr == other.ptr; }
+        constexpr bool operator!=(const Iterator& other) const { return ptr != other.ptr; }
+        constexpr bool operator<(const Iterator& other) const { return ptr < other.ptr; }
+        constexpr bool operator>(const Iterator& other) const { return ptr > other.ptr; }
+        constexpr bool operator<=(const Iterator& other) const { return ptr <= other.ptr; }
+        constexpr bool operator>=(const Iterator& other) const { return ptr >= other.ptr; }
+
+        friend constexpr Iterator operator+(difference_type n, const Iterator& it) { return it + n; }
 
         friend class ConstIterator;
     };
 
     class ConstIterator {
     public:
+        using iterator_concept  = std::contiguous_iterator_tag;
         using iterator_category = std::random_access_iterator_tag;
         using difference_type   = std::ptrdiff_t;
         using value_type        = T;
+        using element_type      = const T;
         using pointer           = const T*;
         using reference         = const T&;
 
@@ -63,30 +88,36 @@ public:
         pointer ptr;
 
     public:
-        explicit ConstIterator(pointer p) : ptr(p) {}
-        ConstIterator(const Iterator& it) : ptr(it.ptr) {}
+        constexpr ConstIterator() : ptr(nullptr) {}
+        constexpr explicit ConstIterator(pointer p) : ptr(p) {}
+        constexpr ConstIterator(const Iterator& it) : ptr(it.ptr) {}
+
+        constexpr reference operator*() const { return *ptr; }
+        constexpr pointer operator->() const { return ptr; }
 
-        reference operator*() const { return *ptr; }
-        pointer operator->() const { return ptr; }
+        constexpr ConstIterator& operator++() { ++ptr; return *this; }
+        constexpr ConstIterator operator++(int) { ConstIterator temp = *this; ++ptr; return temp; }
 
-        ConstIterator& operator++() { ++ptr; return *this; }
-        ConstIterator operator++(int) { ConstIterator temp = *this; ++ptr; return temp; }
+        constexpr ConstIterator& operator--() { --ptr; return *this; }
+        constexpr ConstIterator operator--(int) { ConstIterator temp = *this; --ptr; return temp; }
 
-        ConstIterator& operator--() { --ptr; return *this; }
-        ConstIterator operator--(int) { ConstIterator temp = *this; --ptr; return temp; }
+        constexpr reference operator[](difference_type n) const { return ptr[n]; }
 
-        reference operator[](difference_type n) const { return ptr[n]; }
+        constexpr ConstIterator& operator+=(difference_type n) { ptr += n; return *this; }
+        constexpr ConstIterator& operator-=(difference_type n) { ptr -= n; return *this; }
 
-        ConstIterator operator+(difference_type n) const { return ConstIterator(ptr + n); }
-        ConstIterator operator-(difference_type n) const { return ConstIterator(ptr - n); }
-        difference_type operator-(const ConstIterator& other) const { return ptr - other.ptr; }
+        constexpr ConstIterator operator+(difference_type n) const { return ConstIterator(ptr + n); }
+        constexpr ConstIterator operator-(difference_type n) const { return ConstIterator(ptr - n); }
+        constexpr difference_type operator-(const ConstIterator& other) const { return ptr - other.ptr; }
 
-        bool operator==(const ConstIterator& other) const { return ptr == other.ptr; }
-        bool operator!=(const ConstIterator& other) const { return ptr != other.ptr; }
-        bool operator<(const ConstIterator& other) const { return ptr < other.ptr; }
-        bool operator>(const ConstIterator& other) const { return ptr > other.ptr; }
-        bool operator<=(const ConstIterator& other) const { return ptr <= other.ptr; }
-        bool operator>=(const ConstIterator& other) const { return ptr >= other.ptr; }
+        constexpr bool operator==(const ConstIterator& other) const { return ptr == other.ptr; }
+        constexpr bool operator!=(const ConstIterator& other) const { return ptr != other.ptr; }
+        constexpr bool operator<(const ConstIterator& other) const { return ptr < other.ptr; }
+        constexpr bool operator>(const ConstIterator& other) const { return ptr > other.ptr; }
+        constexpr bool operator<=(const ConstIterator& other) const { return ptr <= other.ptr; }
+        constexpr bool operator>=(const ConstIterator& other) const { return ptr >= other.ptr; }
+
+        friend constexpr ConstIterator operator+(difference_type n, const ConstIterator& it) { return it + n; }
     };
 
 
@@ -101,36 +132,54 @@ private:
 public:
     vector() = default;
 
-    vector(size_t n, const T& value) {
+    explicit vector(const Alloc& alloc) : alloc_(alloc) {}
+
+    vector(size_t n, const T& value, const Alloc& alloc = Alloc()) : alloc_(alloc) {
         allocate(n);
         construct_uniform(value, n);
         end_ = begin_ + n;
     }
 
-    vector(const vector& other) {
-        allocate(other.capacity());
-        end_ = begin_;
-        for (size_t i = 0; i < other.size(); ++i, ++end_) {
-            std::construct_at(end_, other[i]);
-        }
+    vector(const vector& other)
+        : alloc_(traits::select_on_container_copy_construction(other.alloc_)) {
+        copy_from(other.begin_, other.size());
     }
 
+    // The allocator follows propagate_on_container_copy_assignment. When it
+    // does not propagate, the elements are copied into storage from this
+    // vector's own allocator.
     vector& operator=(const vector& other) {
         if (this == &other) return *this;
 
-        destroy_all();
-        deallocate();
-        allocate(other.capacity());
+        if constexpr (traits::propagate_on_container_copy_assignment::value) {
+            if (!same_allocator(other)) {
+                vector tmp(other.alloc_);
+                tmp.copy_from(other.begin_, other.size());
+                destroy_all();
+                deallocate();
+                alloc_ = other.alloc_;
+                swap_storage(tmp);
+                return *this;
+            }
+            alloc_ = other.alloc_;
+        }
 
-        end_ = begin_;
-        for (size_t i = 0; i < other.size(); ++i, ++end_) {
-            std::construct_at(end_, other[i]);
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            if (other.size() <= capacity()) {
+                if (other.size() > 0)
+                    std::memcpy(begin_, other.begin_, other.size() * sizeof(T));
+                end_ = begin_ + other.size();
+                return *this;
+            }
         }
 
+        vector tmp(alloc_);
+        tmp.copy_from(other.begin_, other.size());
+        swap_storage(tmp);
         return *this;
     }
 
-    vector(vector&& other) noexcept{
+    vector(vector&& other) noexcept : alloc_(std::move(other.alloc_)) {
         begin_ = other.begin_;
         end_ = other.end_;
         capacity_ = other.capacity_;
@@ -138,17 +187,33 @@ public:
         other.begin_ = other.end_ = other.capacity_ = nullptr;
     }
 
-    vector& operator=(vector&& other) noexcept {
-        if (this != &other) {
-            destroy_all();
-            deallocate();
-
-            begin_ = other.begin_;
-            end_ = other.end_;
-            capacity_ = other.capacity_;
+    // Takes other's buffer unless the allocator does not propagate on move
+    // and the two compare unequal; then the buffer cannot be freed by this
+    // vector's allocator, so the elements are moved one by one instead.
+    vector& operator=(vector&& other) noexcept(traits::propagate_on_container_move_assignment::value ||
+                                               traits::is_always_equal::value) {
+        if (this == &other) return *this;
 
-            other.begin_ = other.end_ = other.capacity_ = nullptr;
+        if constexpr (!traits::propagate_on_container_move_assignment::value) {
+            if (!same_allocator(other)) {
+                vector tmp(alloc_);
+                tmp.move_from(other.begin_, other.size());
+                swap_storage(tmp);
+                return *this;
+            }
         }
+
+        destroy_all();
+        deallocate();
+
+        if constexpr (traits::propagate_on_container_move_assignment::value)
+            alloc_ = std::move(other.alloc_);
+
+        begin_ = other.begin_;
+        end_ = other.end_;
+        capacity_ = other.capacity_;
+
+        other.begin_ = other.end_ = other.capacity_ = nullptr;
         return *this;
     }
 
@@ -158,29 +223,17 @@ public:
         deallocate();
     }
 
+    // The allocators are exchanged only if propagate_on_container_swap is
+    // set; otherwise they must compare equal.
     void swap(vector& other) noexcept {
-        std::swap(begin_, other.begin_);
-        std::swap(end_, other.end_);
-        std::swap(capacity_, other.capacity_);
-        std::swap(alloc_, other.alloc_);
+        swap_storage(other);
+        if constexpr (traits::propagate_on_container_swap::value)
+            std::swap(alloc_, other.alloc_);
     }
 
     void reserve(size_t n) {
         if (n <= capacity()) return; 
-
-        pointer new_begin = traits::allocate(alloc_, n);
-        pointer new_end = new_begin;
-
-        for (pointer p = begin_; p != end_; ++p, ++new_end) {
-            std::construct_at(new_end, std::move(*p));
-            std::destroy_at(p);
-        }
-
-        traits::deallocate(alloc_, begin_, capacity());
-
-        begin_ = new_begin;
-        end_ = new_end;
-        capacity_ = new_begin + n;
+        reallocate(n);
     }
 
     void shrink_to_fit() {
@@ -215,23 +268,103 @@ public:
     }
 
 
+    void resize(size_t n) {
+        if (n <= size()) {
+            destroy_tail(n);
+            return;
+        }
+
+        grow_to(n);
+        for (pointer last = begin_ + n; end_ != last; ++end_)
+            std::construct_at(end_);
+    }
+
+    void resize(size_t n, const T& value) {
+        if (n <= size()) {
+            destroy_tail(n);
+            return;
+        }
+
+        grow_to(n);
+        for (pointer last = begin_ + n; end_ != last; ++end_)
+            std::construct_at(end_, value);
+    }
+
+    // Like resize(n), but new elements are default-initialized: trivially
+    // constructible types are left uninitialized instead of being zeroed.
+    void resize_default_init(size_t n) {
+        if (n <= size()) {
+            destroy_tail(n);
+            return;
+        }
+
+        grow_to(n);
+        if constexpr (std::is_trivially_default_constructible_v<T>) {
+            end_ = begin_ + n;
+        } else {
+            for (pointer last = begin_ + n; end_ != last; ++end_)
+                ::new (static_cast<void*>(end_)) T;
+        }
+    }
+
+    // Grows to n default-initialized elements, then calls op(data(), n) to fill
+    // the buffer in place. op returns the number of elements to keep, which
+    // must not exceed n.
+    template <typename Op>
+    void resize_and_overwrite(size_t n, Op op) {
+        if (n > size()) resize_default_init(n);
+        size_t kept = static_cast<size_t>(op(begin_, n));
+        destroy_tail(kept);
+    }
+
+    struct buffer {
+        pointer data;
+        size_t size;
+        size_t capacity;
+    };
+
+    // Takes ownership of capacity elements of storage obtained from
+    // get_allocator(), of which the first size are constructed. The current
+    // contents are destroyed and freed first.
+    void adopt(pointer data, size_t size, size_t capacity) {
+        if (size > capacity) throw std::invalid_argument("vector::adopt: size exceeds capacity");
+        if (data == nullptr && capacity != 0) throw std::invalid_argument("vector::adopt: null buffer");
+        if (data == begin_ && data != nullptr) throw std::invalid_argument("vector::adopt: buffer already owned");
+
+        destroy_all();
+        deallocate();
+        begin_ = data;
+        end_ = data + size;
+        capacity_ = data + capacity;
+    }
+
+    // Hands the storage to the caller and leaves the vector empty. The
+    // caller must destroy the size constructed elements and return the
+    // storage through get_allocator().deallocate(data, capacity).
+    buffer release() noexcept {
+        buffer released{begin_, size(), capacity()};
+        begin_ = end_ = capacity_ = nullptr;
+        return released;
+    }
+
+    Alloc get_allocator() const { return alloc_; }
+
     void push_back(const T& value) {
-        if (full()) reallocate(capacity() == 0 ? 1 : 2 * capacity());
+        if (full()) grow();
 
         std::construct_at(end_, value);
         ++end_;
     }
 
     void push_back(T&& value) {
-        if (full()) reallocate(capacity() == 0 ? 1 : 2 * capacity());
+        if (full()) grow();
         std::construct_at(end_, std::move(value));
         ++end_;
     }
 
     template <typename... Args>
     void emplace_back(Args&&... args) {
-        if (full())
-            reallocate(capacity() == 0 ? 1 : 2 * capacity());
+        if (full()) grow();
 
         std::construct_at(end_, std::forward<Args>(args)...);
         ++end_;
@@ -265,12 +398,24 @@ public:
         return begin_[ind];
     }
 
+    reference front() { return *begin_; }
+    constReference front() const { return *begin_; }
+    reference back() { return end_[-1]; }
+    constReference back() const { return end_[-1]; }
+
     pointer data() { return begin_; }
-    const pointer data() const { return begin_; }
+    const T* data() const { return begin_; }
 
 
     size_t size() const noexcept { return end_ - begin_; }
     size_t capacity() const noexcept { return capacity_ - begin_; }
+    bool empty() const noexcept { return end_ == begin_; }
+
+    memory_usage_breakdown memory_breakdown() const noexcept {
+        return {size() * sizeof(T), 0, (capacity() - size()) * sizeof(T)};
+    }
+
+    size_t memory_usage() const noexcept { return capacity() * sizeof(T); }
 
     Iterator begin() noexcept { return Iterator(begin_); }
     Iterator end() noexcept { return Iterator(end_); }
@@ -282,35 +427,92 @@ public:
     ConstIterator cend() const noexcept { return ConstIterator(end_); }
 
     Iterator insert(ConstIterator pos, constReference value) {
-        size_t index = pos - begin_;
+        return emplace(pos, value);
+    }
+
+    Iterator insert(ConstIterator pos, T&& value) {
+        return emplace(pos, std::move(value));
+    }
+
+    // The new element is built before anything shifts, so args may refer
+    // into this vector.
+    template <typename... Args>
+    Iterator emplace(ConstIterator pos, Args&&... args) {
+        size_t index = pos - cbegin();
+        T value(std::forward<Args>(args)...);
         shift_right(index);
-        std::construct_at(begin_ + index, value);
+        std::construct_at(begin_ + index, std::move(value));
         ++end_;
         return Iterator(begin_ + index);
     }
 
-    Iterator erase(ConstIterator pos{
-        size_t ind = pos - begin_;
-        std::destroy_at(begin_ + ind);
-        shift_left(ind);
-        --end_;
-        return Iterator(begin_ + ind);
+    Iterator erase(ConstIterator pos) {
+        return erase(pos, pos + 1);
     }
 
     Iterator erase(ConstIterator first, ConstIterator last) {
-        size_t start = first - begin_;
+        size_t start = first - cbegin();
         size_t count = last - first;
+        if (count == 0) return Iterator(begin_ + start);
 
-        for (size_t i = 0; i < count; ++i)
-            std::destroy_at(begin_ + start + i);
+        move_down(begin_ + start + count, end_, begin_ + start);
+        destroy_tail(size() - count);
+        return Iterator(begin_ + start);
+    }
 
-        for (size_t i = start + count; i < size(); ++i) {
-            std::construct_at(begin_ + i - count, std::move(begin_[i]));
-            std::destroy_at(begin_ + i);
+    // Removes every element matching pred in one pass, keeping the order of
+    // the rest. pred is called once per element, in order. Each run of kept
+    // elements is moved down in one go when the next match ends it. Returns
+    // the number of elements removed.
+    template <typename Pred>
+    size_t erase_if(Pred pred) {
+        pointer out = begin_;
+        pointer run = begin_;
+
+        for (pointer p = begin_; p != end_; ++p) {
+            if (!pred(*p)) continue;
+
+            move_down(run, p, out);
+            out += p - run;
+            run = p + 1;
         }
+        move_down(run, end_, out);
+        out += end_ - run;
 
-        end_ -= count;
-        return Iterator(begin_ + start);
+        size_t removed = end_ - out;
+        destroy_tail(out - begin_);
+        return removed;
+    }
+
+    // Removes the elements at the given positions, which must be sorted in
+    // ascending order, moving each surviving run down once.
+    size_t remove_indices(std::span<const size_t> indices) {
+        if (indices.empty()) return 0;
+
+        size_t n = size();
+        size_t out = indices[0];
+
+        for (size_t k = 0; k < indices.size(); ++k) {
+            size_t from = indices[k] + 1;
+            size_t to = k + 1 < indices.size() ? indices[k + 1] : n;
+            if (to < from) continue;
+
+            move_down(begin_ + from, begin_ + to, begin_ + out);
+            out += to - from;
+        }
+
+        size_t removed = n - out;
+        destroy_tail(out);
+        return removed;
+    }
+
+    // O(1) removal that fills the gap with the last element, so the order of
+    // the remaining elements is not preserved.
+    Iterator swap_remove(ConstIterator pos) {
+        pointer p = begin_ + (pos - cbegin());
+        if (p != end_ - 1) *p = std::move(*(end_ - 1));
+        pop_back();
+        return Iterator(p);
     }
 
 
@@ -330,20 +532,117 @@ private:
         }
     }
 
+    // Fills an empty vector with copies of src[0, n), allocating exactly n.
+    // Trivially copyable elements are copied with a single memcpy; otherwise a
+    // throwing copy destroys what was built and releases the storage.
+    void copy_from(const T* src, size_t n) {
+        if (n == 0) return;
+        allocate(n);
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memcpy(begin_, src, n * sizeof(T));
+            end_ = begin_ + n;
+        } else {
+            try {
+                for (size_t i = 0; i < n; ++i, ++end_)
+                    std::construct_at(end_, src[i]);
+            } catch (...) {
+                destroy_all();
+                deallocate();
+                throw;
+            }
+        }
+    }
+
+    // As copy_from, but moves the elements out of src.
+    void move_from(T* src, size_t n) {
+        if (n == 0) return;
+        allocate(n);
+
+        if constexpr (std::is_trivially_copyable_v<T>) {
+            std::memcpy(begin_, src, n * sizeof(T));
+            end_ = begin_ + n;
+        } else {
+            try {
+                for (size_t i = 0; i < n; ++i, ++end_)
+                    std::construct_at(end_, std::move(src[i]));
+            } catch (...) {
+                destroy_all();
+                deallocate();
+                throw;
+            }
+        }
+    }
+
+    void swap_storage(vector& other) noexcept {
+        std::swap(begin_, other.begin_);
+        std::swap(end_, other.end_);
+        std::swap(capacity_, other.capacity_);
+    }
+
+    bool same_allocator(const vector& other) const noexcept {
+        if constexpr (traits::is_always_equal::value)
+            return true;
+        else
+            return alloc_ == other.alloc_;
+    }
+
     void construct_uniform(const T& value, size_t n) {
         for (size_t i = 0; i < n; ++i)
             std::construct_at(begin_ + i, value);
         end_ = begin_ + n;
     }
 
+    void destroy_tail(size_t n) noexcept {
+        pointer new_end = begin_ + n;
+        while (end_ > new_end) {
+            --end_;
+            std::destroy_at(end_);
+        }
+    }
+
     void destroy_all() {
         for (pointer p = begin_; p != end_; ++p)
             std::destroy_at(p);
         end_ = begin_;
     }
 
+    void grow() {
+        reallocate(Growth::next_capacity(capacity()));
+    }
+
+    // Room for n elements, growing at least geometrically so that a run of
+    // small resizes stays amortized O(1) per element.
+    void grow_to(size_t n) {
+        if (n <= capacity()) return;
+
+        size_t next = Growth::next_capacity(capacity());
+        reallocate(next > n ? next : n);
+    }
+
+    allocation<pointer> allocate_storage(size_t n) {
+        if constexpr (Growth::uses_size_classes)
+            return allocate_at_least(alloc_, n);
+        else
+            return {traits::allocate(alloc_, n), n};
+    }
+
     void reallocate(size_t newCapacity) {
-        pointer new_begin = traits::allocate(alloc_, newCapacity);
+        growth_trace trace(growth_site::vector, this, capacity(), sizeof(T));
+
+        if constexpr (std::is_trivially_copyable_v<T> &&
+                      requires(Alloc& a, pointer p) { a.reallocate(p, size_t{}, size_t{}); }) {
+            if (begin_) {
+                size_t sz = size();
+                begin_ = alloc_.reallocate(begin_, capacity(), newCapacity);
+                end_ = begin_ + sz;
+                capacity_ = begin_ + newCapacity;
+                trace.finish(newCapacity);
+                return;
+            }
+        }
+
+        auto [new_begin, granted] = allocate_storage(newCapacity);
         pointer new_end = new_begin;
 
         for (pointer p = begin_; p != end_; ++p, ++new_end) {
@@ -355,7 +654,9 @@ private:
 
         begin_ = new_begin;
         end_ = new_end;
-        capacity_ = new_begin + newCapacity;
+        capacity_ = new_begin + granted;
+
+        trace.finish(granted);
     }
 
     bool full() const {
@@ -363,7 +664,7 @@ private:
     }
 
     void shift_right(size_t index) {
-        if (full()) reallocate(capacity() == 0 ? 1 : 2 * capacity());
+        if (full()) grow();
 
         for (size_t i = size(); i > index; --i) {
             std::construct_at(begin_ + i, std::move(begin_[i - 1]));
@@ -372,11 +673,14 @@ private:
 
     }
 
-    void shift_left(size_t index){
-        for (size_t i = index; i < size() - 1; ++i){
-            std::construct_at(begin_ + i, std::move(begin_[i + 1]));
-            std::destroy_at(begin_ + i + 1);
-        }
-    }
-};
+    // Moves [first, last) down to dest (dest <= first), leaving the vacated
+    // tail for the caller to destroy.
+    void move_down(pointer first, pointer last, pointer dest) {
+        if (first == dest || first == last) return;
 
+        if constexpr (std::is_trivially_copyable_v<T>)
+            std::memmove(dest, first, (last - first) * sizeof(T));
+        else
+            std::move(first, last, dest);
+    }
+};
\ No newline at end of file
@@ -0,0 +1,156 @@
+// Checks every simd_* entry point at every level the CPU supports against
+// the <algorithm> equivalent, over lengths and alignments that exercise the
+// vector body, the tail and the unaligned head of each kernel.
+//
+//   g++ -std=c++20 -O2 -Iinclude tests/simd_test.cpp -o simd_test && ./simd_test
+//
+// Prints each failing case and exits with status 1 if there is any.
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "algorithm/simd.h"
+#include "small_vector/small_vector.h"
+#include "stable_vector/stable_vector.h"
+#include "vector/vector.h"
+
+static_assert(simd_contiguous<vector<int>>);
+static_assert(simd_contiguous<small_vector<int, 8>>);
+static_assert(simd_contiguous<std::array<float, 4>>);
+static_assert(!simd_contiguous<stable_vector<int>>);
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                                                                               \
+    do {                                                                                                               \
+        if (!(cond)) {                                                                                                 \
+            ++failures;                                                                                                \
+            std::printf("FAIL %s:%d: %s [", __FILE__, __LINE__, #cond);                                              \
+            std::printf(__VA_ARGS__);                                                                                  \
+            std::printf("]\n");                                                                                        \
+        }                                                                                                              \
+    } while (0)
+
+static const char* level_name(simd_level level) {
+    constexpr const char* names[] = {"scalar", "sse42", "avx2", "avx512"};
+    return names[static_cast<int>(level)];
+}
+
+static const size_t lengths[] = {0, 1, 2, 3, 4, 5, 7, 8, 9, 15, 16, 17, 31, 32, 33, 47, 63, 64, 65, 100, 127, 128, 129, 1000, 4099};
+
+// Values drawn from a small range so that find and count see duplicates.
+template <typename T>
+static std::vector<T> random_values(std::mt19937& rng, size_t n) {
+    std::uniform_int_distribution<int> dist(-20, 20);
+    std::vector<T> values(n);
+    for (T& v : values)
+        v = static_cast<T>(dist(rng));
+    return values;
+}
+
+template <typename T>
+static void check_type(const char* type, simd_level level, std::mt19937& rng) {
+    const char* lv = level_name(level);
+
+    for (size_t n : lengths) {
+        // Start at 0..3 elements into the buffer so the kernels see unaligned
+        // heads as well as aligned ones.
+        for (size_t offset = 0; offset < 4; ++offset) {
+            std::vector<T> buffer = random_values<T>(rng, n + offset);
+            const T* data = buffer.data() + offset;
+
+            for (T value : {T(0), T(5), T(19), T(100)}) {
+                size_t expected = std::find(data, data + n, value) - data;
+                CHECK(simd_find(data, n, value) == expected, "%s %s n=%zu offset=%zu", lv, type, n, offset);
+                CHECK(simd_count(data, n, value) == size_t(std::count(data, data + n, value)), "%s %s n=%zu offset=%zu",
+                      lv, type, n, offset);
+                CHECK(simd_contains(data, n, value) == (expected != n), "%s %s n=%zu offset=%zu", lv, type, n, offset);
+            }
+
+            // The match placed last, so only the tail can find it.
+            if (n > 0) {
+                std::vector<T> last(data, data + n);
+                std::replace(last.begin(), last.end(), T(77), T(0));
+                last.back() = T(77);
+                CHECK(simd_find(last.data(), n, T(77)) == n - 1, "%s %s n=%zu", lv, type, n);
+            }
+
+            if (n > 0) {
+                auto [lo, hi] = std::minmax_element(data, data + n);
+                auto result = simd_min_max(data, n);
+                CHECK(result.first == *lo && result.second == *hi, "%s %s n=%zu offset=%zu", lv, type, n, offset);
+            }
+
+            std::vector<T> copy(data, data + n);
+            CHECK(simd_equal(data, copy.data(), n), "%s %s n=%zu offset=%zu", lv, type, n, offset);
+            for (size_t i : {size_t(0), n / 2, n - 1}) {
+                if (n == 0) break;
+                std::vector<T> changed = copy;
+                changed[i] = T(changed[i] + 1);
+                CHECK(!simd_equal(data, changed.data(), n), "%s %s n=%zu offset=%zu i=%zu", lv, type, n, offset, i);
+            }
+
+            std::vector<T> filled(n + offset + 1, T(-1));
+            simd_fill(filled.data() + offset, n, T(3));
+            bool fill_ok = std::all_of(filled.begin(), filled.begin() + offset, [](T v) { return v == T(-1); }) &&
+                           std::all_of(filled.begin() + offset, filled.end() - 1, [](T v) { return v == T(3); }) &&
+                           filled.back() == T(-1);
+            CHECK(fill_ok, "%s %s n=%zu offset=%zu", lv, type, n, offset);
+        }
+    }
+
+    std::mt19937 container_rng;
+    vector<T> v;
+    CHECK(simd_find(v, T(1)) == 0 && simd_count(v, T(1)) == 0 && !simd_contains(v, T(1)), "%s %s empty", lv, type);
+    for (T x : random_values<T>(container_rng, 200))
+        v.push_back(x);
+    std::vector<T> reference(v.begin(), v.end());
+    CHECK(simd_count(v, T(4)) == size_t(std::count(reference.begin(), reference.end(), T(4))), "%s %s vector", lv,
+          type);
+    simd_fill(v, T(9));
+    CHECK(std::all_of(v.begin(), v.end(), [](T x) { return x == T(9); }), "%s %s vector", lv, type);
+}
+
+static void check_popcount(simd_level level, std::mt19937& rng) {
+    for (size_t n : lengths) {
+        for (size_t offset = 0; offset < 4; ++offset) {
+            std::vector<uint64_t> words(n + offset);
+            for (uint64_t& w : words)
+                w = (uint64_t(rng()) << 32) | rng();
+            if (n > 0) words[offset] = ~uint64_t(0);
+
+            size_t expected = 0;
+            for (size_t i = offset; i < n + offset; ++i)
+                expected += std::popcount(words[i]);
+            CHECK(simd_popcount(words.data() + offset, n) == expected, "%s popcount n=%zu offset=%zu",
+                  level_name(level), n, offset);
+        }
+    }
+}
+
+int main() {
+    simd_level detected = simd_detected_level();
+
+    for (int l = 0; l <= static_cast<int>(detected); ++l) {
+        simd_level level = static_cast<simd_level>(l);
+        simd_set_level(level);
+        CHECK(simd_active_level() == level, "%s", level_name(level));
+
+        std::mt19937 rng(l);
+        check_type<int32_t>("int32_t", level, rng);
+        check_type<uint32_t>("uint32_t", level, rng);
+        check_type<float>("float", level, rng);
+        check_type<int64_t>("int64_t", level, rng);
+        check_type<int16_t>("int16_t", level, rng);
+        check_popcount(level, rng);
+        std::printf("%s: done\n", level_name(level));
+    }
+
+    simd_set_level(detected);
+    if (failures) std::printf("%d failures\n", failures);
+    return failures ? 1 : 0;
+}